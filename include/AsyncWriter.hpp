@@ -0,0 +1,98 @@
+/** \file AsyncWriter.hpp
+ *
+ * Background thread writing the text and binary outputs
+ */
+
+#ifndef ASYNCWRITERHPP
+#define ASYNCWRITERHPP
+
+#include <deque>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <pthread.h>
+
+/** Singleton owning the output files of Notebook, ColumnWriter and the
+ * processors text outputs. Writes are queued and done by a background
+ * thread, so slow storage does not stall the event processing. The queue
+ * is bounded (jobs, not bytes): if the disk can't keep up the caller
+ * waits until there is space. Jobs for a given file are done in order.
+ *
+ * Files are opened by the worker on the first write (appending) unless
+ * Open() was called first. Flush() is requested at the end of each spill
+ * and all files are flushed and closed at exit.
+ *
+ * Errors in the worker are stored and reported by a Messenger warning at
+ * the next Flush() and at Shutdown(). Nothing is thrown to the caller,
+ * which may be the spill end called from the Fortran scan (hissub_).*/
+class AsyncWriter {
+public:
+    /** Returns only instance of AsyncWriter class.*/
+    static AsyncWriter* get();
+
+    /** Opens file, truncating it if requested */
+    void Open(const std::string& file, bool truncate);
+    /** Appends data to file. The string is taken over (swapped),
+     * it is empty after the call */
+    void Write(const std::string& file, std::string& data);
+    /** Requests flush of all open files and reports the errors of the
+     * worker since the last call */
+    void Flush();
+    /** Closes file */
+    void Close(const std::string& file);
+    /** Waits until all jobs queued so far are done */
+    void Sync();
+    /** Finishes all queued jobs, closes files and stops the thread.
+     * Later calls are done synchronously. */
+    void Shutdown();
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    AsyncWriter();
+    /* Do not implement*/
+    AsyncWriter(AsyncWriter const&);
+    void operator=(AsyncWriter const&);
+    static AsyncWriter* instance;
+
+    struct Job {
+        enum Kind {OPEN, WRITE, FLUSH, CLOSE, STOP};
+        Kind kind;
+        bool truncate;
+        std::string file;
+        std::string data;
+    };
+
+    /** Queues job (waits if the queue is full), data is swapped */
+    void Push(Job::Kind kind, const std::string& file,
+              std::string* data = NULL, bool truncate = false);
+    /** Executes job, called by the worker only (or after Shutdown) */
+    void Execute(Job& job);
+    void Loop();
+    static void* Run(void* self);
+    static void ShutdownAtExit();
+    /** Shows the stored errors, if any, and clears them */
+    void Report();
+
+    std::deque<Job> queue_;
+    size_t capacity_;
+    /** Number of jobs queued and done, used by Sync() */
+    unsigned long pushed_;
+    unsigned long done_;
+    bool running_;
+    /** Last error of the worker and number of errors not reported yet */
+    std::string error_;
+    unsigned long errors_;
+
+    pthread_t thread_;
+    pthread_mutex_t mutex_;
+    pthread_cond_t notEmpty_;
+    pthread_cond_t notFull_;
+    pthread_cond_t jobsDone_;
+
+    /** Open files, used by the worker only */
+    std::map<std::string, std::ofstream*> sinks_;
+};
+
+#endif
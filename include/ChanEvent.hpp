@@ -30,11 +30,16 @@ private:
     double calTime;            /**< Calibrated time, currently unused */
     double correctedTime;      /**< Energy-walk corrected time */
     double highResTime;        /**< timing resolution less than 1 adc size */
-    Trace trace;               /**< Channel trace if present */
+    mutable std::vector<pixie::halfword_t> rawTrace; /**< Packed 16-bit trace
+                                                samples as read from pixie,
+                                                released once expanded */
+    mutable Trace trace;       /**< Channel trace if present, expanded from
+                                  rawTrace on the first request */
+    mutable bool traceExpanded; /**< True if trace holds the rawTrace samples */
     pixie::word_t trigTime;    /**< The channel trigger time, trigger time and the lower 32 bits
 				  of the event time are not necessarily the same but could be
 				  separated by a constant value.*/
-    pixie::word_t cfdTime;     /**< CFD trigger time in units of 1/256 pixie clock ticks */
+    pixie::word_t cfdTime;     /**< Raw CFD trigger time word, see GetCfdPhase() */
     pixie::word_t eventTimeLo; /**< Lower 32 bits of pixie16 event time */
     pixie::word_t eventTimeHi; /**< Upper 32 bits of pixie16 event time */
     pixie::word_t runTime0;    /**< Lower bits of run time */
@@ -42,6 +47,9 @@ private:
     pixie::word_t runTime2;    /**< Higher bits of run time */
     static const int numQdcs = 8;     /**< Number of QDCs onboard */
     pixie::word_t qdcValue[numQdcs];  /**< QDCs from onboard */
+    static const int numEsums = 4;    /**< Number of onboard energy sums */
+    pixie::word_t esumValue[numEsums]; /**< Onboard sums: trailing, leading,
+                                          gap and baseline (float) */
 
     double time;               /**< Raw channel time, 64 bit from pixie16 channel event time */
     double eventTime;          /**< The event time recorded by Pixie */
@@ -53,10 +61,13 @@ private:
     bool   saturatedBit;       /**< Saturation flag from Pixie */
 
     void ZeroNums(void);       /**< Zero members which do not have constructors associated with them */
+    void ExpandTrace(void) const; /**< Move rawTrace samples into the int trace */
     
     // make the front end responsible for reading the data able to set the channel data directly
     friend int ReadBuffDataA(pixie::word_t *, unsigned long *, std::vector<ChanEvent *> &);
     friend int ReadBuffDataDF(pixie::word_t *, unsigned long *, std::vector<ChanEvent *> &);
+    // the built events cache stores and restores the channel data directly
+    friend class EventCache;
 public:
     //static const double pixieEnergyContraction = 1.0; ///< energies from pixie16 are contracted by this number
 
@@ -75,8 +86,27 @@ public:
     double GetCalTime() const     {return calTime;}    /**< Get the calibrated time */
     double GetHighResTime() const {return highResTime;} /**< Get the high-resolution time */
     double GetEventTime() const   {return eventTime;}  /**< Get the event time */
-    const Trace& GetTrace() const {return trace;} /**< Get a reference to the trace */
-    Trace& GetTrace() {return trace;} /** Get a reference which can alter the trace */
+    const Trace& GetTrace() const {
+        if (!traceExpanded)
+            ExpandTrace();
+        return trace;
+    } /**< Get a reference to the trace */
+    Trace& GetTrace() {
+        if (!traceExpanded)
+            ExpandTrace();
+        return trace;
+    } /** Get a reference which can alter the trace */
+    Trace& GetSampleTrace() {
+        if (!traceExpanded)
+            trace.SetPacked(&rawTrace);
+        return trace;
+    } /**< Get the trace reading the packed samples if it is not expanded,
+         for the analyzers using only Trace::Sample() and the Trace methods */
+    const std::vector<pixie::halfword_t>& GetRawTrace() const
+    {return rawTrace;} /**< Get the packed 16-bit samples without expanding,
+                          empty once GetTrace() was called */
+    bool HasTrace() const
+    {return !rawTrace.empty() || !trace.empty();} /**< True if any trace samples are present */
     unsigned long GetTrigTime() const    
     {return trigTime;}    /**< Return the channel trigger time */
     unsigned long GetEventTimeLo() const
@@ -99,6 +129,12 @@ public:
     int GetID() const;                   /**< Get the channel id defined as
 					    pixie module # * 16 + channel number */
     unsigned long GetQdcValue(int i) const; /**< Get an onboard QDC value */
+    bool HasEsums() const
+    {return esumValue[0] != pixie::U_DELIMITER;} /**< True if the onboard sums were read out */
+    unsigned long GetEsumValue(int i) const; /**< Get an onboard energy sum */
+    double GetEsumBaseline() const;  /**< Get the onboard baseline */
+    double GetEsumEnergy(double tau, double rise) const; /**< Energy from the onboard sums */
+    double GetCfdPhase() const; /**< CFD time in adc clock ticks, NAN if not valid */
 
     ChanEvent();
     void ZeroVar();
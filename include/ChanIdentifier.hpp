@@ -28,15 +28,22 @@ public:
     void SetType(const std::string &a)    {type = a;}     /**< Set the detector type */
     void SetSubtype(const std::string &a) {subtype = a;}  /**< Set the detector subtype */
     void SetLocation(int a)   {location = a;} /**< Set the detector location */
+    void SetOnboard(bool a)   {onboard = a;}  /**< Use onboard CFD and sums */
+    void SetEsumTau(double a) {esumTau = a;}  /**< Set the decay constant for the energy sums (s) */
+    void SetEsumRise(double a) {esumRise = a;} /**< Set the energy filter rise time (s) */
     
     int GetDammID() const                 {return dammID;}   /**< Get the dammid */
     const std::string& GetType() const    {return type;}     /**< Get the detector type */
     const std::string& GetSubtype() const {return subtype;}  /**< Get the detector subtype */
     int GetLocation() const               {return location;} /**< Get the detector location */
+    bool UseOnboard() const               {return onboard;}  /**< True if onboard values replace trace analysis */
+    double GetEsumTau() const             {return esumTau;}  /**< Get the energy sums decay constant (s) */
+    double GetEsumRise() const            {return esumRise;} /**< Get the energy filter rise time (s) */
     
     void AddTag(const std::string &s, TagValue n) {tag[s] = n;} /**< Insert a tag */
     bool HasTag(const std::string &s) const {return (tag.count(s) > 0);} /**< True if the tag s has been inserted */
     TagValue GetTag(const std::string &s) const; 
+    const std::map<std::string, TagValue>& GetTags() const {return tag;} /**< All tags of the identifier */
 
     Identifier();
     void Zero();
@@ -82,6 +89,10 @@ private:
     int dammID;            /**< Damm spectrum number for plotting calibrated energies */
     int location;          /**< Specifies the real world location of the channel.
   			        For the DSSD this variable is the strip number */
+    bool onboard;          /**< Take time and energy from the onboard CFD and
+                                energy sums instead of the trace */
+    double esumTau;        /**< Decay constant used with the energy sums */
+    double esumRise;       /**< Rise time of the onboard energy filter */
     std::map<std::string, TagValue> tag;  /**< A list of tags associated with the identifer */ 
 };
 
@@ -0,0 +1,128 @@
+/** \file ColumnFile.hpp
+ *
+ * Columnar event output without ROOT: writer used by ColumnProcessor
+ * and a minimal reader
+ *
+ * File layout (little endian, as written by the machine):
+ *   header: "PXCOLUMN", uint32 version, uint32 number of columns,
+ *           for each column: uint32 name length, name, uint8 type
+ *   chunks: uint32 number of rows, then for each column:
+ *           uint32 compressed size, zlib compressed values
+ * Values of a column are fixed width (see ColumnType), the chunks follow
+ * each other until the end of the file.
+ */
+
+#ifndef COLUMNFILEHPP
+#define COLUMNFILEHPP
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/** Type of the values in a column */
+enum ColumnType {
+    column_double = 0, //< 8 bytes
+    column_int = 1     //< 4 bytes
+};
+
+/** Writes events as columns. Processors bind their variables to columns
+ * (similar to ROOT branch addresses), Fill() copies the current values to
+ * the column buffers and every chunkSize rows the buffers are compressed
+ * and handed to the AsyncWriter in bulk. The rows left are written at the
+ * end of each spill (FlushAll) and the files are closed at exit.*/
+class ColumnWriter {
+public:
+    ColumnWriter(const std::string& fileName, unsigned chunkSize = 4096);
+    /** Writes the remaining rows and closes the file */
+    ~ColumnWriter();
+
+    /** Binds a variable to a new column, must be called before the first
+     * Fill(). The variable must stay valid as long as the writer. */
+    void AddColumn(const std::string& name, const double* value);
+    void AddColumn(const std::string& name, const int* value);
+    /** Unsigned variables are stored as int columns */
+    void AddColumn(const std::string& name, const unsigned* value);
+
+    /** Adds a row with the current values of all bound variables */
+    void Fill();
+    /** Writes the buffered rows as a chunk */
+    void Flush();
+    /** Writes the remaining rows and closes the file */
+    void Close();
+
+    /** Writes the buffered rows of all the open writers */
+    static void FlushAll();
+
+    unsigned long GetEntries() const {
+        return entries_;
+    }
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        const void* address;
+        std::vector<char> buffer;
+    };
+
+    void AddColumn(const std::string& name, ColumnType type,
+                   const void* address);
+    void WriteHeader();
+
+    static void CloseAtExit();
+    /** Writers not closed yet */
+    static std::vector<ColumnWriter*> open_;
+
+    std::string fileName_;
+    unsigned chunkSize_;
+    unsigned rows_;
+    unsigned long entries_;
+    bool headerWritten_;
+    bool closed_;
+    std::vector<Column> columns_;
+    std::vector<unsigned char> compressed_;
+};
+
+/** Minimal reader of the column files, loads one chunk at a time */
+class ColumnReader {
+public:
+    /** Opens the file and reads the header, throws IOException */
+    ColumnReader(const std::string& fileName);
+
+    unsigned GetNumColumns() const {
+        return columns_.size();
+    }
+    const std::string& GetName(unsigned column) const {
+        return columns_.at(column).name;
+    }
+    ColumnType GetType(unsigned column) const {
+        return columns_.at(column).type;
+    }
+    /** Returns index of the column of a given name, -1 if not found */
+    int Find(const std::string& name) const;
+
+    /** Loads the next chunk, returns false at the end of the file */
+    bool NextChunk();
+    /** Number of rows in the loaded chunk */
+    unsigned GetRows() const {
+        return rows_;
+    }
+    /** Value of the row of the loaded chunk, converted to double */
+    double Get(unsigned column, unsigned row) const;
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        std::vector<char> values;
+    };
+
+    std::ifstream in_;
+    std::string fileName_;
+    unsigned rows_;
+    std::vector<Column> columns_;
+    std::vector<unsigned char> compressed_;
+};
+
+#endif
@@ -0,0 +1,31 @@
+/** \file ColumnProcessor.hpp
+ *
+ * Processor to dump data from events into a columnar file, the ROOT-free
+ * counterpart of RootProcessor
+ */
+
+#ifndef __COLUMNPROCESSOR_HPP_
+#define __COLUMNPROCESSOR_HPP_
+
+#include <string>
+#include <vector>
+
+#include "EventProcessor.hpp"
+
+class ColumnWriter;
+
+class ColumnProcessor : public EventProcessor
+{
+ private:
+    ColumnWriter *writer; //< Output file
+
+    /// All processors which added columns
+    std::vector<EventProcessor *> vecProcess;
+ public:
+    ColumnProcessor(const std::string &fileName, unsigned chunkSize);
+    virtual bool Init(RawEvent& rawev);
+    virtual bool Process(RawEvent &event);
+    virtual ~ColumnProcessor();
+};
+
+#endif // __COLUMNPROCESSOR_HPP_
@@ -0,0 +1,103 @@
+/** \file ConfigSnapshot.hpp
+ *
+ * Binary snapshot of the resolved channel map, calibrations and walk
+ * corrections, reused as long as Config.xml does not change
+ */
+
+#ifndef CONFIGSNAPSHOTHPP
+#define CONFIGSNAPSHOTHPP
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "ChanIdentifier.hpp"
+
+/** Fully resolved <Channel> of the map (location already assigned) */
+struct SnapshotChannel {
+    int module;
+    int channel;
+    Identifier id;
+};
+
+/** One <Calibration> or <WalkCorrection> of a channel */
+struct SnapshotParams {
+    int module;
+    int channel;
+    std::string model;
+    double min;
+    double max;
+    std::vector<double> parameters;
+};
+
+/** Singleton holding the snapshot. On the first call to get() the file
+ * Config.xml.snapshot is memory-mapped and loaded if its version and the
+ * hash of Config.xml match, in such a case loaded() is true and
+ * DetectorLibrary::LoadXml, DetectorDriver::ReadCalXml and ReadWalkXml
+ * take the records from here. Otherwise these functions parse the xml
+ * as usual, add the records, and DetectorDriver::Init calls save() to
+ * write a new snapshot for the next run.
+ *
+ * The TreeCorrelator tree is not part of the snapshot, it is always built
+ * from the xml.*/
+class ConfigSnapshot {
+public:
+    /** Returns only instance of ConfigSnapshot class.*/
+    static ConfigSnapshot* get();
+
+    /** True if the snapshot was loaded from a valid file */
+    bool loaded() const {
+        return loaded_;
+    }
+
+    void addChannel(int module, int channel, const Identifier& id);
+    void addCalibration(int module, int channel, const std::string& model,
+                        double min, double max,
+                        const std::vector<double>& parameters);
+    void addWalk(int module, int channel, const std::string& model,
+                 double min, double max,
+                 const std::vector<double>& parameters);
+
+    const std::vector<SnapshotChannel>& channels() const {
+        return channels_;
+    }
+    const std::vector<SnapshotParams>& calibrations() const {
+        return calibrations_;
+    }
+    const std::vector<SnapshotParams>& walks() const {
+        return walks_;
+    }
+
+    /** Writes the snapshot if it was not loaded from file. Failure to
+     * write is reported as a warning only. */
+    void save();
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    ConfigSnapshot();
+    /* Do not implement*/
+    ConfigSnapshot(ConfigSnapshot const&);
+    void operator=(ConfigSnapshot const&);
+    static ConfigSnapshot* instance;
+
+    /** Returns 64-bit FNV-1a hash of the file, 0 if it can't be read */
+    static uint64_t hashFile(const std::string& name);
+
+    /** Loads snapshot from file, returns false if file is missing,
+     * of different version or hash, or damaged */
+    bool load();
+
+    bool loaded_;
+    uint64_t hash_;
+    std::string file_name_;
+
+    std::vector<SnapshotChannel> channels_;
+    std::vector<SnapshotParams> calibrations_;
+    std::vector<SnapshotParams> walks_;
+
+    /** Increase whenever the layout of the file changes */
+    static const uint32_t version_ = 1;
+};
+
+#endif
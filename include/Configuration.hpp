@@ -0,0 +1,58 @@
+/** \file Configuration.hpp
+ *
+ * Parsed Config.xml shared by all parts of the program
+ */
+
+#ifndef CONFIGURATIONHPP
+#define CONFIGURATIONHPP
+
+#include <string>
+#include "pugixml.hpp"
+
+/** Singleton holding the Config.xml document. The file is parsed and
+ * validated once, upon the first call to get(); Globals, DetectorLibrary,
+ * DetectorDriver, TreeCorrelator, Notebook and the processors take their
+ * sections from here instead of loading the file again.
+ *
+ * The sections are handed out as pugi::xml_node, which does not enforce
+ * constness: treat them as read-only.*/
+class Configuration {
+public:
+    /** Returns only instance of Configuration class.*/
+    static Configuration* get();
+
+    /** Returns <Configuration> child of a given name, empty node
+     * if section is not present (same as pugi::xml_node::child) */
+    pugi::xml_node section(const std::string& name) const {
+        return root_.child(name.c_str());
+    }
+
+    /** Returns the <Configuration> node */
+    pugi::xml_node root() const {
+        return root_;
+    }
+
+    /** Name of the parsed file */
+    const std::string& fileName() const {
+        return file_name_;
+    }
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    Configuration();
+    /* Do not implement*/
+    Configuration(Configuration const&);
+    void operator=(Configuration const&);
+    static Configuration* instance;
+
+    /** Checks that required sections are present and warns about
+     * unknown ones, throws GeneralException on error */
+    void validate();
+
+    std::string file_name_;
+    pugi::xml_document doc_;
+    pugi::xml_node root_;
+};
+
+#endif
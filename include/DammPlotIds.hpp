@@ -142,6 +142,8 @@ namespace dammIds {
         const int D_NUMBER_OF_EVENTS = 1510;
         const int D_HAS_TRACE = 1511;
 //	const int DD_RAW_V_CAL = 1512;
+        const int DD_DEAD_FRACTION = 1513;
+        const int DD_INPUT_RATE = 1514;
     
 
     }
@@ -48,13 +48,19 @@ class DetectorDriver {
                       double val3 = -1, const char* name="h") {
         histo.Plot(dammId, val1, val2, val3, name);
     }
+    void plotWeighted(int dammId, int x, int y, int weight) {
+        histo.PlotWeighted(dammId, x, y, weight);
+    }
     
-    int ProcessEvent(RawEvent& rawev);
+    int ProcessEvent(RawEvent& rawev, bool calibrated = false);
+    void AnalyzeTraces(const std::vector<ChanEvent*> &eventList);
     int ThreshAndCal(ChanEvent *, RawEvent& rawev);
+    void FillSummaries(ChanEvent *, RawEvent& rawev);
     int Init(RawEvent& rawev);
 
     int PlotRaw(const ChanEvent *);
     int PlotCal(const ChanEvent *);
+    void PlotStats(unsigned mod); /**< plot the dead time of the module */
 
     void DeclarePlots(); /**< declare the necessary damm plots */
     void SanityCheck(void) const;  /**< check whether everything makes sense */
@@ -91,6 +97,16 @@ class DetectorDriver {
     
     std::vector<TraceAnalyzer *> vecAnalyzer; /**< object which analyzes traces of channels to extract
 				   energy and time information */
+    std::vector< std::vector<unsigned> > chanAnalyzers; /**< indexes in vecAnalyzer
+                                   accepting each channel, built in Init */
+    std::vector< std::vector<ChanEvent*> > traceBatches; /**< traced hits of
+                                   a spill grouped by analyzer */
+    std::vector<char> chanExpand; /**< true for the channels with an analyzer
+                                   needing the int trace, built in Init */
+    std::vector<ChanEvent*> tracedHits; /**< traced hits of a spill with at
+                                   least one analyzer, see PrepareTraces */
+    std::vector<int> chanPlaces; /**< TreeCorrelator handle of the place of
+                                   each channel, -1 if none, built in Init */
     std::set<std::string> knownDetectors; /**< list of valid detectors that can 
 				   be used as detector types */
     
@@ -105,6 +121,9 @@ class DetectorDriver {
     }
 
     void LoadProcessors(Messenger& m);
+    void MapAnalyzers();
+    static void PrepareTraces(void* driver, size_t begin, size_t end);
+    void MapPlaces();
 
     void ReadCalXml();
     void ReadWalkXml();
@@ -58,6 +58,8 @@ private:
     static DetectorLibrary* instance;
 
     void LoadXml();
+    void AddChannel(int module, int ch, const Identifier& id,
+                    bool verbose, bool verbose_tree);
 
     mapkey_t MakeKey( const std::string &type, const std::string &subtype ) const;
 
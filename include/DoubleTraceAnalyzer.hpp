@@ -34,6 +34,11 @@ class DoubleTraceAnalyzer : public TraceFilterer
     virtual bool Init(void) {return TraceFilterer::Init();}
     virtual void DeclarePlots(void);
     virtual void Analyze(Trace &, const std::string &, const std::string &);
+    /** Position (top/bottom) traces are not searched for double pulses */
+    virtual bool Accepts(const std::string &,
+                         const std::string &subtype) const {
+        return (subtype != "top" && subtype != "bottom");
+    }
 };
 
 #endif // __DOUBLETRACEANALYZER_HPP_
@@ -186,6 +186,9 @@ protected:
 
 	double betaWin_;
 
+	/** EventTap probe for the beta-decay-proton records, -1 if off */
+	int betaDecayProbe_;
+
 	// correlation time window
 	double correlationMatrixWin_;
 	double gammaProtonWin_;
@@ -0,0 +1,75 @@
+/** \file EventCache.hpp
+ *
+ * Cache of built and calibrated events for fast reprocessing
+ */
+
+#ifndef EVENTCACHEHPP
+#define EVENTCACHEHPP
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class ChanEvent;
+class RawEvent;
+
+/** Singleton storing the events built in ScanList after ThreshAndCal
+ * (energies, times, trace analysis values and optionally the traces) and
+ * replaying them into DetectorDriver::ProcessEvent, so processors can be
+ * rerun without reading, sorting, building and analyzing the traces again.
+ *
+ * Enabled by the <EventCache file="..." mode="write|replay"
+ * traces="True|False"/> node of the Global section, see Globals.*/
+class EventCache {
+public:
+    /** Returns only instance of EventCache class.*/
+    static EventCache* get();
+
+    /** True if events are written to the cache */
+    bool writing() const {
+        return mode_ == WRITE;
+    }
+
+    /** True if events are taken from the cache instead of the data */
+    bool replaying() const {
+        return mode_ == REPLAY;
+    }
+
+    /** Stores calibrated channels of the current event */
+    void Write(const std::vector<ChanEvent*>& event);
+
+    /** Marks the end of the spill and flushes the file, called after
+     * each spill is scanned */
+    void EndSpill();
+
+    /** Processes all events from the cache, calling endSpill at each
+     * spill boundary as the scan does, returns number of events */
+    unsigned long Replay(RawEvent& rawev, void (*endSpill)());
+
+    ~EventCache();
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    EventCache();
+    /* Do not implement*/
+    EventCache(EventCache const&);
+    void operator=(EventCache const&);
+    static EventCache* instance;
+
+    void WriteChannel(const ChanEvent* chan);
+    /** Reads one channel, returns NULL on end of file or error */
+    ChanEvent* ReadChannel(std::ifstream& in, bool withTraces);
+
+    enum Mode {NONE, WRITE, REPLAY};
+    Mode mode_;
+    bool traces_;
+    std::string file_name_;
+    std::ofstream out_;
+
+    /** Increase whenever the layout of the file changes */
+    static const uint32_t version_ = 2;
+};
+
+#endif
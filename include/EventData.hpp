@@ -1,18 +1,18 @@
 #ifndef EVENT_DATA_H
 #define EVENT_DATA_H
 
-#include <string>
 #include "Globals.hpp"
 
 /** Simple structure holding basic parameters needed for correlation
- * of events in the same place. */
+ * of events in the same place. Plain data, so it can be copied around
+ * the Place fifos without any allocation.*/
 class EventData {
     public:
         /** Time is always needed, by default status is true,  
          * Energy is 0 (i.e. N/A), location -1 (N/A),
-         * and event type is an empty string.*/
+         * and event type is 0 (N/A).*/
         EventData(double ptime, bool pstatus = true, double penergy = 0,
-                  int plocation = -1, std::string ptype = "") {
+                  int plocation = -1, unsigned ptype = 0) {
             time = ptime;
 
             status = pstatus;
@@ -23,7 +23,7 @@ class EventData {
 
         /** Time, energy, location type of constructor */
         EventData(double ptime, double penergy, int plocation = -1,
-                  bool pstatus = true, std::string ptype = "") {
+                  bool pstatus = true, unsigned ptype = 0) {
             time = ptime;
             energy = penergy;
             location = plocation;
@@ -36,7 +36,8 @@ class EventData {
         double time;
         double energy;
         int location;
-        std::string type;
+        /** User defined event type id, 0 if not used */
+        unsigned type;
 };
 
 #endif
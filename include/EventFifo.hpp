@@ -0,0 +1,115 @@
+#ifndef EVENT_FIFO_H
+#define EVENT_FIFO_H
+
+#include <vector>
+#include <stdexcept>
+
+#include "EventData.hpp"
+
+/** Fixed capacity ring buffer holding the history of a Place. The storage
+ * is allocated once in the constructor, adding an event to a full fifo
+ * overwrites the oldest one. Index 0 is the oldest event, size() - 1 the
+ * most recent one (same as the deque used before).
+ *
+ * The fifo counts neighbours out of time order, so users may search
+ * the history by time when timeOrdered() is true. Only push_back is
+ * tracked, events modified through operator[] or at() are not.*/
+class EventFifo {
+    public:
+        EventFifo(unsigned capacity = 2) : data_(capacity, EventData(-1)) {
+            capacity_ = capacity;
+            first_ = 0;
+            size_ = 0;
+            inversions_ = 0;
+        }
+
+        /** Adds event at the end, drops the oldest one if full */
+        void push_back(const EventData& info) {
+            if (capacity_ == 0)
+                return;
+            if (size_ > 0 && capacity_ > 1 && info.time < back().time)
+                ++inversions_;
+            if (size_ < capacity_) {
+                data_[index_(size_)] = info;
+                ++size_;
+            } else {
+                // the pair of the two oldest events is leaving
+                if (size_ > 1 && (*this)[1].time < (*this)[0].time)
+                    --inversions_;
+                data_[first_] = info;
+                ++first_;
+                if (first_ == capacity_)
+                    first_ = 0;
+            }
+        }
+
+        EventData& operator[] (unsigned index) {
+            return data_[index_(index)];
+        }
+
+        const EventData& operator[] (unsigned index) const {
+            return data_[index_(index)];
+        }
+
+        /** Range checked access, throws std::out_of_range */
+        EventData& at(unsigned index) {
+            if (index >= size_)
+                throw std::out_of_range("EventFifo::at");
+            return data_[index_(index)];
+        }
+
+        const EventData& at(unsigned index) const {
+            if (index >= size_)
+                throw std::out_of_range("EventFifo::at");
+            return data_[index_(index)];
+        }
+
+        /** Most recent event, fifo must not be empty */
+        EventData& back() {
+            return data_[index_(size_ - 1)];
+        }
+
+        const EventData& back() const {
+            return data_[index_(size_ - 1)];
+        }
+
+        unsigned size() const {
+            return size_;
+        }
+
+        unsigned capacity() const {
+            return capacity_;
+        }
+
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        /** True if the events are in non-decreasing time order */
+        bool timeOrdered() const {
+            return inversions_ == 0;
+        }
+
+        void clear() {
+            first_ = 0;
+            size_ = 0;
+            inversions_ = 0;
+        }
+
+    private:
+        unsigned index_(unsigned index) const {
+            unsigned i = first_ + index;
+            if (i >= capacity_)
+                i -= capacity_;
+            return i;
+        }
+
+        std::vector<EventData> data_;
+        unsigned capacity_;
+        unsigned first_;
+        unsigned size_;
+        /** Number of neighbours out of time order */
+        unsigned inversions_;
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "TreeCorrelator.hpp"
 
 // forward declarations
+class ColumnWriter;
 class DetectorSummary;
 class RawEvent;
 
@@ -48,12 +49,23 @@ class EventProcessor {
     virtual void plot(int dammId, double val1, double val2 = -1, double val3 = -1, const char* name="h") {
         histo.Plot(dammId, val1, val2, val3, name);
     }
+    /** Plots (val1, val2) and (val2, val1) of a symmetric histogram */
+    virtual void symplot(int dammId, double val1, double val2) {
+        histo.PlotSymmetric(dammId, val1, val2);
+    }
     virtual void DeclareHistogram1D(int dammId, int xSize, const char* title) {
         histo.DeclareHistogram1D(dammId, xSize, title);
     }
     virtual void DeclareHistogram2D(int dammId, int xSize, int ySize, const char* title) {
         histo.DeclareHistogram2D(dammId, xSize, ySize, title);
     }
+    virtual void DeclareSymmetric2D(int dammId, int size, const char* title) {
+        histo.DeclareSymmetric2D(dammId, size, title);
+    }
+    virtual void DeclareSparse2D(int dammId, int xSize, int ySize,
+                                 const char* title) {
+        histo.DeclareSparse2D(dammId, xSize, ySize, title);
+    }
 
  public:
     EventProcessor();
@@ -77,6 +89,9 @@ class EventProcessor {
     std::string GetName(void) const {
       return name;
     }
+    // columnar output, see ColumnProcessor
+    virtual bool AddColumns(ColumnWriter *writer);
+    virtual void FillColumns(void);
 #ifdef useroot
     virtual bool AddBranch(TTree *tree);
     virtual void FillBranch(void);
@@ -0,0 +1,124 @@
+/** \file EventTap.hpp
+ *
+ * Filtered capture of raw channels, built events and processor values
+ */
+
+#ifndef EVENTTAPHPP
+#define EVENTTAPHPP
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class ChanEvent;
+
+/** Fixed size record of the tap file */
+struct TapRecord {
+    /** Number of the built event (raw channels: events built so far) */
+    uint32_t event;
+    /** One of EventTap::RAW, BUILT or PROBE */
+    uint16_t kind;
+    /** Channel id (RAW, BUILT) or probe number (PROBE) */
+    uint16_t id;
+    /** RAW: time, energy, cfd phase, pileup, saturated;
+     *  BUILT: time, energy, calibrated energy, corrected time, high
+     *  resolution time; PROBE: values given by the processor */
+    double values[5];
+};
+
+/** Singleton replacing the ad-hoc debug files (readbuff.txt, wall clock
+ * dumps in ProcessEvent, processors text outputs). Channels passing one of
+ * the filters, and values recorded by processors through named probes,
+ * are stored as TapRecord in a buffer allocated at startup and written in
+ * blocks by the AsyncWriter.
+ *
+ * Configured by the optional section
+ * \code
+ * <EventTap file="tap.bin" records="65536">
+ *     <Filter kind="raw|built|both" type="" subtype=""
+ *             emin="" emax="" start="" stop="" wall_start="" wall_stop=""
+ *             first_event="" last_event=""/>
+ *     <Probe name="beta-decay-proton"/>
+ * </EventTap>
+ * \endcode
+ * All the Filter attributes are optional, start/stop are in seconds of the
+ * Pixie clock, wall_start/wall_stop in seconds since epoch. A built event
+ * is stored whole if any of its channels passes a filter.
+ *
+ * Without the section the tap is disabled and the only cost is the
+ * inline check of enabled() at each capture point.*/
+class EventTap {
+public:
+    /** Returns only instance of EventTap class.*/
+    static EventTap* get();
+
+    /** True if the tap is configured, valid after the first get() */
+    static bool enabled() {
+        return enabled_;
+    }
+
+    enum Kind {RAW = 0, BUILT = 1, PROBE = 2};
+
+    /** Stores the channel as read from the buffer, if it passes a filter */
+    void Raw(const ChanEvent* chan);
+
+    /** Stores all the calibrated channels of the event if any passes
+     * a filter, counts the built events */
+    void Built(const std::vector<ChanEvent*>& event);
+
+    /** Returns number of the probe of a given name, -1 if the probe is
+     * not requested (or the tap is disabled). Processors call it once
+     * and keep the number. */
+    int Probe(const std::string& name) const;
+
+    /** Stores up to 5 values for the probe (number from Probe()) */
+    void Record(int probe, const double* values, unsigned n);
+
+    /** Hands the buffered records to the AsyncWriter */
+    void Flush();
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    EventTap();
+    /* Do not implement*/
+    EventTap(EventTap const&);
+    void operator=(EventTap const&);
+    static EventTap* instance;
+    static bool enabled_;
+
+    static void FlushAtExit();
+
+    struct Filter {
+        bool raw;
+        bool built;
+        std::string type;
+        std::string subtype;
+        double emin;
+        double emax;
+        double start;
+        double stop;
+        double wallStart;
+        double wallStop;
+        double firstEvent;
+        double lastEvent;
+    };
+
+    /** True if the channel passes any of the filters for a given kind */
+    bool Pass(const ChanEvent* chan, Kind kind) const;
+
+    /** Reserves next record in the buffer, flushing it if full */
+    TapRecord& Next(Kind kind, unsigned id);
+
+    std::vector<Filter> filters_;
+    std::vector<std::string> probes_;
+    std::vector<TapRecord> buffer_;
+    size_t used_;
+    uint32_t events_;
+    std::string file_name_;
+
+    /** Increase whenever the layout of the file changes */
+    static const uint32_t version_ = 1;
+};
+
+#endif
@@ -175,6 +175,19 @@ protected:
     static const unsigned int chansPerClover = 4; /*!< number of channels per clover */
     
     std::map<int, int> leafToClover;   /*!< Translate a leaf location to a clover number */
+    std::vector<int> cloverByLocation_; /*!< leafToClover indexed by location */
+    /** Low gain event of each location in the current event, used
+     * for the high/low gain matching, empty between events */
+    std::vector<ChanEvent*> lowByLocation_;
+    /** Handle of the Beta place, -1 until first used */
+    int betaPlace_;
+
+    /** Clover number of a leaf location */
+    int CloverOf(int location) const {
+        if (location < 0 || location >= (int)cloverByLocation_.size())
+            return 0;
+        return cloverByLocation_[location];
+    }
     std::vector<float> timeResolution; /*!< Contatin time resolutions used */
     unsigned int numClovers;           /*!< number of clovers in map */
 
@@ -194,9 +207,9 @@ protected:
     void DeclareHistogramGranY(int dammId, int xsize, int ysize, 
 			       const char *title, int halfWordsPerChan,
 			       const std::vector<float> &granularity, const char *units );
-    void granploty(int dammId, double x, double y, 
-                   const std::vector<float> &granularity);
-    void symplot(int dammID, double bin1, double bin2);
+    void granploty(int dammId, double x, double y) {
+        histo.PlotGranularY(dammId, x, y);
+    }
 
     /** addbackEvents vector of vectors, where first vector
      * enumerates cloves, second events
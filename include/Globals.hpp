@@ -187,6 +187,29 @@ class Globals {
             return numTraces_;
         }
 
+        /** Built events cache file, empty if not used */
+        std::string eventCacheFile() const {
+            return eventCacheFile_;
+        }
+
+        /** Built events cache mode: "write" stores events after
+         * calibration, "replay" processes the stored events instead
+         * of the data */
+        std::string eventCacheMode() const {
+            return eventCacheMode_;
+        }
+
+        /** True if traces are stored in the built events cache */
+        bool eventCacheTraces() const {
+            return eventCacheTraces_;
+        }
+
+        /** Number of threads preparing the traces of a spill, see
+         * WorkerPool. If not set, by default is 1. */
+        unsigned traceThreads() const {
+            return traceThreads_;
+        }
+
     private:
         /** Make constructor, copy-constructor and operator =
          * private to complete singleton implementation.*/
@@ -210,6 +233,10 @@ class Globals {
         std::vector< std::pair<int, int> > reject_;
         std::string configPath_;
         unsigned short numTraces_;
+        std::string eventCacheFile_;
+        std::string eventCacheMode_;
+        bool eventCacheTraces_;
+        unsigned traceThreads_;
 };
 
 
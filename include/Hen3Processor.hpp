@@ -17,6 +17,9 @@ public:
     virtual void DeclarePlots(void);
 protected:
     EventData BestBetaForNeutron(double nTime);
+    /** Handle of the Neutron_<location> place, resolved on first use */
+    unsigned NeutronPlace(int location);
+    std::vector<int> neutronPlaces_;
     static double const cycleTimePlotResolution_ = 1e-3;
     static double const diffTimePlotResolution_ = 1e-6;
 };
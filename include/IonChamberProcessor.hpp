@@ -6,9 +6,8 @@
 #ifndef __IONCHAMBERPROCESSOR_HPP_
 #define __IONCHAMBERPROCESSOR_HPP_
 
-#include <deque>
-
 #include "EventProcessor.hpp"
+#include "RateEstimator.hpp"
 
 class IonChamberProcessor : public EventProcessor 
 {
@@ -25,14 +24,15 @@ class IonChamberProcessor : public EventProcessor
     void Clear(void);
   } data;
 
-  double lastTime[noDets];
-  std::deque<double> timeDiffs[noDets];
+  RateEstimator rates[noDets];
  public:
   IonChamberProcessor(); // no virtual c'tors
   virtual bool Process(RawEvent &event);
   virtual void DeclarePlots(void);
   // nice and simple raw derived class
 
+  bool AddColumns(ColumnWriter *writer);
+  void FillColumns(void);
 #ifdef useroot
   bool AddBranch(TTree *tree);
   void FillBranch(void);
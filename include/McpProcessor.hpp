@@ -15,6 +15,8 @@ class McpProcessor : public EventProcessor
   virtual void DeclarePlots(void);
   virtual bool Process(RawEvent &rEvent);
   
+  virtual bool AddColumns(ColumnWriter *writer);
+  virtual void FillColumns(void);
 #ifdef useroot
   virtual bool AddBranch(TTree *tree);
   virtual void FillBranch(void);
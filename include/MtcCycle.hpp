@@ -0,0 +1,120 @@
+/** \file MtcCycle.hpp
+ *
+ * State of the measurement cycle driven by the MTC and beam signals
+ */
+
+#ifndef __MTCCYCLE_HPP_
+#define __MTCCYCLE_HPP_
+
+#include <string>
+
+class Identifier;
+
+/** Singleton holding the state of the tape cycle: tape move, beam on/off,
+ * cycle number and the times of the last transitions. The MtcProcessor
+ * (and the BeamLogicProcessor for the beam) drive the transitions, other
+ * processors read the state directly instead of asking the
+ * TreeCorrelator for the Beam, Cycle and TapeMove places by name.
+ *
+ * The places are still updated on each transition so the correlator
+ * tree built on them works as before, and the initial state is read
+ * from them (e.g. init="true" of the Cycle place).*/
+class MtcCycle {
+public:
+    /** Returns only instance of MtcCycle class.*/
+    static MtcCycle* get();
+
+    /** MTC signals, resolved once per channel with SignalOf() */
+    enum Signal {NONE = -1,
+                 MOVE_START = 0, ///< leading edge of the tape move
+                 MOVE_STOP = 1,  ///< trailing edge of the tape move
+                 BEAM_START = 2,
+                 BEAM_STOP = 3,
+                 NUM_SIGNALS = 4};
+
+    /** Signal of a channel (mtc type, location 0), NONE for others */
+    static Signal SignalOf(const Identifier& id);
+
+    /** Records a hit of the signal, also one rejected afterwards
+     * as double, returns the time of its previous hit (-1 if none) */
+    double Hit(Signal signal, double time) {
+        double previous = lastHit_[signal];
+        lastHit_[signal] = time;
+        return previous;
+    }
+
+    /** Time of the last hit of the signal, -1 if none */
+    double LastHit(Signal signal) const {
+        return lastHit_[signal];
+    }
+
+    /** Applies the transition of the signal at time */
+    void Transition(Signal signal, double time);
+
+    /** Changes the beam state only (beam logic signal) */
+    void SetBeam(bool on, double time);
+
+    bool IsBeamOn() const {
+        return beamOn_;
+    }
+
+    /** True from a beam start to the next tape move start */
+    bool IsInCycle() const {
+        return inCycle_;
+    }
+
+    bool IsTapeMoving() const {
+        return tapeMoving_;
+    }
+
+    /** Time of the last cycle change: the beam start that opened the
+     * cycle when in cycle, the tape move start otherwise */
+    double CycleTime() const {
+        return cycleTime_;
+    }
+
+    /** Time of the last beam change (on or off) */
+    double BeamTime() const {
+        return beamTime_;
+    }
+
+    /** Number of cycles started */
+    unsigned CycleNumber() const {
+        return cycleNumber_;
+    }
+
+    /** Time since the cycle change (see CycleTime()) in seconds */
+    double TimeInCycle(double time) const;
+
+    /** Time since the last beam change in seconds */
+    double TimeSinceBeam(double time) const;
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    MtcCycle();
+    /* Do not implement*/
+    MtcCycle(MtcCycle const&);
+    void operator=(MtcCycle const&);
+    static MtcCycle* instance;
+
+    /** Handle of the place of a given name, -1 if it does not exist */
+    static int PlaceHandle(const std::string& name);
+
+    /** Activates or deactivates the place if it exists */
+    static void SetPlace(int handle, bool on, double time);
+
+    bool beamOn_;
+    bool inCycle_;
+    bool tapeMoving_;
+    double cycleTime_;
+    double beamTime_;
+    unsigned cycleNumber_;
+    double lastHit_[NUM_SIGNALS];
+
+    int beamPlace_;
+    int cyclePlace_;
+    int tapeMovePlace_;
+};
+
+#endif // __MTCCYCLE_HPP_
@@ -6,6 +6,8 @@
 #ifndef __MTCPROCESSOR_HPP_
 #define __MTCPROCESSOR_HPP_
 
+#include <vector>
+
 #include "EventProcessor.hpp"
 
 class MtcProcessor : public EventProcessor {
@@ -14,6 +16,7 @@ class MtcProcessor : public EventProcessor {
      * */
     MtcProcessor(bool double_stop, bool double_start);
 
+    virtual bool Init(RawEvent &event);
     virtual void DeclarePlots(void);
     virtual bool PreProcess(RawEvent &event);
     virtual bool Process(RawEvent &event);
@@ -26,6 +29,9 @@ class MtcProcessor : public EventProcessor {
      * this flags enable removal of such an events */
     bool double_start_;
 
+    /** MtcCycle::Signal of each channel, indexed by channel id */
+    std::vector<int> signals_;
+
     /** Upper limit in seconds for bad (double) start/stop event */
     static const double doubleTimeLimit_ = 10e-6;
 };
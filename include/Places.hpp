@@ -4,11 +4,11 @@
 #include <cstdlib>
 #include <iostream>
 #include <vector>
-#include <deque>
 #include <utility>
 
 #include "Globals.hpp"
 #include "EventData.hpp"
+#include "EventFifo.hpp"
 
 /** A pure abstract class to define a "place" for correlator.
  * A place has physical or abstract meaning, might be a detector, 
@@ -18,14 +18,17 @@ class Place {
     public:
         /** C'tor. By default the Place is resetable, and internal
          * fifo remebers only current and previous event.*/
-        Place(bool resetable = true, unsigned max_size = 2) {
+        Place(bool resetable = true, unsigned max_size = 2) :
+            info_(max_size) {
             resetable_ = resetable;
             max_size_ = max_size;
             status_ = false;
+            dirty_ = false;
         }
 
-        virtual ~Place() {
-        }
+        /** Removes place from the dirty list if it is still there
+         * (e.g. place replaced after init activation).*/
+        virtual ~Place();
 
         /** Defines 'child' of place. A child will report any
          * changes of its status to parent. Parent will change its
@@ -109,31 +112,26 @@ class Place {
             return info_.at(index);
         }
 
-        virtual EventData operator [] (unsigned index) const {
+        virtual const EventData& operator [] (unsigned index) const {
             return info_.at(index);
         }
 
         /** Easy access to last (current) element of fifo. If fifo
          * is empty time=-1 event is returned*/
-        virtual EventData last() {
+        virtual const EventData& last() const {
             if (info_.size() > 0)
                 return info_.back();
-            else {
-                EventData empty(-1);
-                return empty;
-            }
+            else
+                return empty_;
         }
 
         /** Easy access to the second to last element of fifo. If fifo
          * has only one event, time=-1 event is returned. */
-        virtual EventData secondlast() {
-            if (info_.size() > 1) {
-                unsigned sz = info_.size();
-                return info_.at(sz - 2);
-            } else {
-                EventData empty(-1);
-                return empty;
-            }
+        virtual const EventData& secondlast() const {
+            if (info_.size() > 1)
+                return info_[info_.size() - 2];
+            else
+                return empty_;
         }
 
         /** Returns true if place should automatically deactivate
@@ -147,7 +145,7 @@ class Place {
         /** Pythonic style private field. Use it if you must,
          * but perhaps you should not. Stores information on past 
          * events in a given Place.*/
-        std::deque<EventData> info_;
+        EventFifo info_;
 
     protected:
         /** Pure virutal function. The check function should decide how
@@ -175,10 +173,14 @@ class Place {
                 (*it)->check_(info);
         }
 
+        /** Every change of state goes through this function, so this is
+         * where resetable places are put on the dirty list. */
         virtual void add_info_(const EventData& info) {
             info_.push_back(info);
-            while (info_.size() > max_size_)
-                info_.pop_front();
+            if (resetable_ && !dirty_) {
+                dirty_ = true;
+                dirty_list_.push_back(this);
+            }
         }
 
         /** Status is true if given place is in active state (e.g. detector
@@ -200,6 +202,18 @@ class Place {
          * should be reported.
          */
         std::vector<Place*> parents_;
+
+        /** True if place is on the dirty list */
+        bool dirty_;
+
+        /** List of resetable places touched since the last end of event,
+         * only these need to be reset (see TreeCorrelator::resetPlaces). */
+        static std::vector<Place*> dirty_list_;
+
+        /** Returned by last() and secondlast() if fifo is too short */
+        static const EventData empty_;
+
+        friend class TreeCorrelator;
 };
 
 /** "Lazy" Place does not store multiple activation or deactivation events.
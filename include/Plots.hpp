@@ -11,13 +11,17 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "Globals.hpp"
 #include "PlotsRegister.hpp"
+#include "SparseHistogram.hpp"
+#include "SymmetricHistogram.hpp"
 
 /* Fortran subroutines for plotting histograms */
 extern "C" void count1cc_(const int &, const int &, const int &);
 extern "C" void set2cc_(const int &, const int &, const int &, const int &);
+extern "C" void add2cc_(const int &, const int &, const int &, const int &);
 
 /** Holds pointers to all Histograms.*/
 class Plots {
@@ -62,8 +66,39 @@ public:
 			    int xContraction, int yContraction, 
 			    const std::string &mne = "");
     
+    /** Declares one 2D histogram (ids dammId, dammId + 1, ...) for each
+     * y granularity (units per bin), filled at once by PlotGranularY */
+    bool DeclareGranularY(int dammId, int xSize, int ySize,
+                          const char* title, int halfWordsPerChan,
+                          const std::vector<float> &granularity,
+                          const char* units);
+
+    /** Declares square histogram filled by PlotSymmetric */
+    bool DeclareSymmetric2D(int dammId, int size, const char* title,
+                            int halfWordsPerChan = 1,
+                            const std::string &mne = "");
+
+    /** Declares 2D histogram collected in tiles during the spill, see
+     * SparseHistogram, for large matrices filled in small regions.
+     * It is filled by Plot as any other 2D histogram. */
+    bool DeclareSparse2D(int dammId, int xSize, int ySize,
+                         const char* title, int halfWordsPerChan = 1,
+                         const std::string &mne = "");
+
     bool Plot(int dammId, double val1, double val2 = -1, double val3 = -1, const char* name="h");
 
+    /** Adds weight to the cell x of a 1D (y is ignored) or (x, y) of a
+     * 2D histogram, as weight calls of Plot but in one update */
+    bool PlotWeighted(int dammId, int x, int y, int weight);
+
+    /** Plots (x, y / granularity) in each histogram declared by
+     * DeclareGranularY, returns false if dammId is not declared so */
+    bool PlotGranularY(int dammId, double x, double y);
+
+    /** Plots (val1, val2) and (val2, val1), see SymmetricHistogram.
+     * Histograms not declared by DeclareSymmetric2D are plotted twice. */
+    bool PlotSymmetric(int dammId, double val1, double val2);
+
     bool Plot(const std::string &mne, double val1, double val2 = -1, double val3 = -1, const char* name="h");
 
 private:
@@ -80,6 +115,25 @@ private:
     std::map <std::string, int> mneList;
     /** Map of dammid -> title, helps debugging duplicated dammids*/
     std::map <int, std::string> titleList;
+    /** Y axis of multi-resolution histograms, granularities in
+     * decreasing order, index is the dammId offset */
+    struct GranularY {
+        int ySize;
+        std::vector< std::pair<float, int> > granularity;
+    };
+    /** Map of first dammid -> y axis */
+    std::map <int, GranularY> granular_;
+    /** Map of dammid -> accumulator (owned by PlotsRegister) */
+    std::map <int, SymmetricHistogram*> symmetric_;
+    /** Sparse accumulator of each dammid (owned by PlotsRegister), NULL
+     * for others, empty if there is no sparse histogram */
+    std::vector <SparseHistogram*> sparse_;
+    /** TimeSlices slot of each dammid, -1 if not sliced, empty if there
+     * is no sliced histogram */
+    std::vector <int> sliced_;
+
+    /** Registers the histogram in the TimeSlices if requested there */
+    void AddSlice(int dammId, int dims);
 };
 
 #endif // __PLOTS_HPP_
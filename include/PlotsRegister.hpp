@@ -6,10 +6,14 @@
 #ifndef __PLOTSREGISTER_HPP_
 #define __PLOTSREGISTER_HPP_
 
+#include <map>
 #include <utility>
 #include <vector>
 #include <string>
 
+class SparseHistogram;
+class SymmetricHistogram;
+
 /** Holds ranges and offsets of all plots. Singleton class. */
 class PlotsRegister {
     public:
@@ -19,6 +23,14 @@ class PlotsRegister {
         bool CheckRange (int offset, int range) const;
         bool Add(int offset, int range, std::string name_);
 
+        /** Creates accumulator for symmetric histogram (absolute id) */
+        SymmetricHistogram* AddSymmetric(int dammId, int size);
+        /** Creates accumulator for sparse histogram (absolute id) */
+        SparseHistogram* AddSparse(int dammId, int xSize, int ySize);
+        /** Writes pending symmetric and sparse plots into DAMM, called
+         * at the end of each spill and of the run */
+        void Flush();
+
     private:
         PlotsRegister() {};
         PlotsRegister (const PlotsRegister&);
@@ -27,6 +39,11 @@ class PlotsRegister {
 
         // Vector of min, max of histogram numbers 
         std::vector< std::pair<int, int> > reg;
+
+        /** Symmetric histograms by absolute DAMM id */
+        std::map<int, SymmetricHistogram*> symmetric_;
+        /** Sparse histograms by absolute DAMM id */
+        std::map<int, SparseHistogram*> sparse_;
 };
 
 #endif // __PLOTSREGISTER_HPP_
@@ -28,13 +28,19 @@ private:
     float posScale;        //< an arbitrary scale for the position parameter to physical units
     std::vector<float> minNormQdc; //< the minimum normalized qdc observed for a location
     std::vector<float> maxNormQdc; //< the maximum normalized qdc observed for a location
-    
-    ChanEvent* FindMatchingEdge(ChanEvent *match,
-				std::vector<ChanEvent*>::const_iterator begin, 
-				std::vector<ChanEvent*>::const_iterator end) const;				
-    ChanEvent* FindMatchingEdge(ChanEvent *match,
-				std::vector<ChanEvent*>::const_reverse_iterator begin, 
-				std::vector<ChanEvent*>::const_reverse_iterator end) const;				
+
+    /** Sum of the trace samples [lo, hi), clipped to the trace length */
+    static float TraceWindow(const Trace &trace, unsigned int lo, unsigned int hi);
+
+    std::vector<ChanEvent*> allSums;                  //< sum and digisum hits of the event
+    std::vector< std::vector<ChanEvent*> > topByLocation;    //< top edges of the event by location
+    std::vector< std::vector<ChanEvent*> > bottomByLocation; //< bottom edges of the event by location
+
+    void IndexEdges(const std::vector<ChanEvent*> &edges,
+                    std::vector< std::vector<ChanEvent*> > &byLocation) const;
+    int FindMatchingEdge(const ChanEvent *match,
+                         const std::vector< std::vector<ChanEvent*> > &byLocation,
+                         ChanEvent *&edge) const;
 public:
     PositionProcessor(); // no virtual c'tors
     virtual bool Init(RawEvent& rawev);
@@ -1,35 +1,65 @@
 /** \file RandomPool.hpp
- *  \brief Holds a pre-generated pool of random numbers
+ *  \brief Counter-based random numbers keyed by the hit
  *
- *  This generates a pool of random numbers using the Mersenne twister.
- *  DTM - 08-18-2010
+ *  Originally a pre-generated pool of Mersenne twister numbers handed out
+ *  through a shared index (DTM - 08-18-2010). The numbers are now computed
+ *  with the Philox4x32-10 generator (Salmon et al., SC11) from the hit
+ *  identity, so there is no state: the same hit gets the same random
+ *  numbers independently of the order of processing or the thread doing it.
  */
 
 #ifndef __RANDOMPOOL_HPP_
 #define __RANDOMPOOL_HPP_
 
-#include "MersenneTwister.hpp"
+#include <stdint.h>
 
-/** 
- *  \brief A random pool of numbers
+/**
+ *  \brief Stateless random numbers for the dithering of integer values
+ *
+ *  The counter is made of the hit time stamp and a draw number, the key
+ *  of the channel id and a stream number separating the users.
  */
 class RandomPool {
-private:
-    RandomPool();
-    RandomPool (const RandomPool&);
-    RandomPool& operator= (RandomPool const&);
-    static RandomPool* instance;
+public:
+    /** Users of the random numbers, each gets independent numbers */
+    enum Stream {
+        CALIBRATION = 0, ///< dithering of the energies in ThreshAndCal
+        TRACE_FILTER = 1 ///< dithering of the energy filter in TraceFilterer
+    };
 
-    static const size_t size = 1000000; ///< default size of the pool
+    /** Returns a random number in the range [0, range) for the draw-th
+     * number of a given stream for the hit of channel id at time stamp */
+    static double Get(Stream stream, unsigned id, uint64_t time,
+                      unsigned draw = 0, double range = 1) {
+        uint32_t ctr[4] = {uint32_t(time), uint32_t(time >> 32), draw, 0};
+        uint32_t key[2] = {id, stream};
+        Philox(ctr, key);
+        // 53 random bits as a double in [0, 1)
+        uint64_t bits = (uint64_t(ctr[0]) << 21) ^ (ctr[1] >> 11);
+        return double(bits) * (1.0 / 9007199254740992.0) * range;
+    }
 
-    MTRand generator;     ///< random number generator
-    size_t counter;       ///< current random number index
-    double numbers[size]; ///< the pool of random numbers
-public:
-    static RandomPool* get();
+    /** Ten rounds of Philox4x32 applied to the counter */
+    static void Philox(uint32_t ctr[4], uint32_t key[2]) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            uint64_t p0 = uint64_t(0xD2511F53u) * ctr[0];
+            uint64_t p1 = uint64_t(0xCD9E8D57u) * ctr[2];
+            uint32_t c0 = uint32_t(p1 >> 32) ^ ctr[1] ^ key[0];
+            uint32_t c2 = uint32_t(p0 >> 32) ^ ctr[3] ^ key[1];
+            ctr[1] = uint32_t(p1);
+            ctr[3] = uint32_t(p0);
+            ctr[0] = c0;
+            ctr[2] = c2;
+        }
+    }
 
-    void Generate(void);        
-    double Get(double range = 1); 
+private:
+    /* Not to be instantiated */
+    RandomPool();
 };
 
 #endif // __RANDOMPOOL_HPP_
@@ -0,0 +1,137 @@
+/** \file RateEstimator.hpp
+ *
+ * Dead time corrected rate estimate from the times of the hits
+ */
+
+#ifndef __RATEESTIMATOR_HPP_
+#define __RATEESTIMATOR_HPP_
+
+#include <vector>
+#include <limits>
+
+/** Streaming estimate of the rate of a Poisson source from the times of
+ * its hits, in the inverse of the time unit used (clock ticks for the
+ * pixie times).
+ *
+ * Intervals shorter than the dead time are dropped, the dead time is
+ * subtracted from the others. Thanks to the memorylessness of the
+ * exponential distribution the remaining intervals have the same mean
+ * 1/rate, so the estimate is not biased by the dead time.
+ *
+ * The intervals are kept in a ring of fixed size with a running sum
+ * (mean of the last window intervals) and in an exponential moving
+ * average (weight 1/window), both updated in constant time per hit.*/
+class RateEstimator {
+    public:
+        RateEstimator(unsigned window = 1000, double deadTime = 0) :
+                intervals_(window > 0 ? window : 1, 0) {
+            deadTime_ = deadTime;
+            alpha_ = 1.0 / intervals_.size();
+            Clear();
+        }
+
+        /** Forgets all hits */
+        void Clear() {
+            lastTime_ = std::numeric_limits<double>::quiet_NaN();
+            lastInterval_ = std::numeric_limits<double>::quiet_NaN();
+            next_ = 0;
+            size_ = 0;
+            sum_ = 0;
+            ema_ = std::numeric_limits<double>::quiet_NaN();
+        }
+
+        /** Adds a hit at time, returns true if the interval to the
+         * previous hit passed the dead time and was used */
+        bool Add(double time) {
+            bool first = !HasLast();
+            lastInterval_ = time - lastTime_;
+            lastTime_ = time;
+            if (first || !(lastInterval_ > deadTime_))
+                return false;
+
+            double interval = lastInterval_ - deadTime_;
+            if (size_ == intervals_.size())
+                sum_ -= intervals_[next_];
+            else
+                ++size_;
+            intervals_[next_] = interval;
+            sum_ += interval;
+            ++next_;
+            if (next_ == intervals_.size()) {
+                next_ = 0;
+                Resum();
+            }
+
+            if (ema_ != ema_)
+                ema_ = interval;
+            else
+                ema_ += alpha_ * (interval - ema_);
+            return true;
+        }
+
+        /** True once a hit was added */
+        bool HasLast() const {
+            return lastTime_ == lastTime_;
+        }
+
+        /** Time from the previous hit to the last one (with dead time),
+         * NaN before the second hit */
+        double LastInterval() const {
+            return lastInterval_;
+        }
+
+        /** True if the window is filled with intervals */
+        bool Full() const {
+            return size_ == intervals_.size();
+        }
+
+        /** Number of intervals in the window */
+        unsigned Count() const {
+            return size_;
+        }
+
+        /** Rate from the mean interval of the window, NaN if empty */
+        double Rate() const {
+            if (size_ == 0 || sum_ <= 0)
+                return std::numeric_limits<double>::quiet_NaN();
+            return size_ / sum_;
+        }
+
+        /** Rate from the exponential moving average of the intervals,
+         * reacts to changes without waiting for a full window */
+        double EmaRate() const {
+            if (!(ema_ > 0))
+                return std::numeric_limits<double>::quiet_NaN();
+            return 1.0 / ema_;
+        }
+
+        /** True rate of a source seen with a measured (counting) rate
+         * by a non-paralyzable system of a given dead time */
+        static double DeadTimeCorrected(double measuredRate, double deadTime) {
+            double live = 1.0 - measuredRate * deadTime;
+            if (!(live > 0))
+                return std::numeric_limits<double>::infinity();
+            return measuredRate / live;
+        }
+
+    private:
+        /** Recomputes the running sum once per turn of the ring, so the
+         * rounding errors of the updates do not accumulate */
+        void Resum() {
+            sum_ = 0;
+            for (unsigned i = 0; i < size_; ++i)
+                sum_ += intervals_[i];
+        }
+
+        std::vector<double> intervals_;
+        double deadTime_;
+        double alpha_;
+        double lastTime_;
+        double lastInterval_;
+        unsigned next_;
+        unsigned size_;
+        double sum_;
+        double ema_;
+};
+
+#endif // __RATEESTIMATOR_HPP_
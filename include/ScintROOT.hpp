@@ -13,6 +13,8 @@ class TTree;
 class ScintROOT : public ScintProcessor
 {
  public:
+    bool AddColumns(ColumnWriter *writer);
+    void FillColumns(void);
     bool AddBranch (TTree *tree);
     void FillBranch(void);
 
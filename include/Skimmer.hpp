@@ -0,0 +1,107 @@
+/** \file Skimmer.hpp
+ *
+ * Writing of the selected spills to a reduced list mode file
+ */
+
+#ifndef __SKIMMER_HPP_
+#define __SKIMMER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "Globals.hpp"
+
+class ChanEvent;
+
+/** Singleton writing the spills which pass the selection to a new .ldf
+ * file, so that later passes of the analysis read only the interesting
+ * part of the run. The file is read by the normal scan: it starts with
+ * the DIR and HEAD records copied from the source file, the spills are
+ * written as in the original data (chunks in DATA records) and it ends
+ * with two EOF records.
+ *
+ * Configured by the optional section
+ * \code
+ * <Skim file="skim.ldf" source="run_001.ldf">
+ *     <Select type="dssd_front" subtype="" emin="" emax="" min_hits="1"/>
+ * </Skim>
+ * \endcode
+ * A spill is kept if, for any of the Select nodes, at least min_hits of
+ * its channels (after ReadBuffData decoding) have the type, subtype
+ * (empty matches all) and raw energy in [emin, emax].
+ *
+ * Spills are kept or dropped as a whole, so the module buffers are
+ * written as they came. Of the dropped spills only the statistics blocks
+ * and the clock buffers are written (as a spill of otherwise empty
+ * module buffers), so the statistics of the run and the wall clock
+ * correlation are preserved.*/
+class Skimmer {
+public:
+    /** Returns only instance of Skimmer class.*/
+    static Skimmer* get();
+
+    /** True if the skim is configured, valid after the first get() */
+    static bool enabled() {
+        return enabled_;
+    }
+
+    /** Evaluates the selection on the decoded channels of the spill */
+    void Select(const std::vector<ChanEvent*>& eventList);
+
+    /** Writes the spill (module buffers as given to MakeModuleData),
+     * whole if it was selected, its statistics only otherwise */
+    void EndSpill(const pixie::word_t* data, unsigned long nWords);
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    Skimmer();
+    /* Do not implement*/
+    Skimmer(Skimmer const&);
+    void operator=(Skimmer const&);
+    static Skimmer* instance;
+    static bool enabled_;
+
+    static void FinishAtExit();
+
+    struct Selection {
+        std::string type;
+        std::string subtype;
+        double emin;
+        double emax;
+        unsigned minHits;
+    };
+
+    /** Copies the module buffers keeping the statistics blocks only,
+     * returns false if there is none (and no clock buffer) */
+    bool Reduce(const pixie::word_t* data, unsigned long nWords,
+                std::vector<pixie::word_t>& reduced) const;
+
+    /** Splits the spill into chunks and adds them to the records */
+    void WriteSpill(const pixie::word_t* data, unsigned long nWords);
+
+    /** Adds the chunk to the current DATA record */
+    void WriteChunk(const pixie::word_t* data, unsigned long nWords,
+                    unsigned total, unsigned number);
+
+    /** Adds a record of a given type (4 characters) to the output */
+    void AddRecord(const char* type, const std::vector<pixie::word_t>& data);
+
+    /** Completes the current DATA record */
+    void EndRecord();
+
+    /** Writes the last DATA record and the EOF records */
+    void Finish();
+
+    std::vector<Selection> selections_;
+    std::vector<unsigned> hits_;
+    bool keep_;
+    std::vector<pixie::word_t> record_;
+    size_t used_;
+    std::string output_;
+    std::string file_name_;
+    unsigned long kept_;
+    unsigned long dropped_;
+};
+
+#endif // __SKIMMER_HPP_
@@ -0,0 +1,88 @@
+/** \file SparseHistogram.hpp
+ *
+ * Accumulation of large, mostly empty 2D plots
+ */
+
+#ifndef __SPARSEHISTOGRAM_HPP_
+#define __SPARSEHISTOGRAM_HPP_
+
+#include <vector>
+
+/** Collects the counts of a large 2D histogram in tiles of tileSize x
+ * tileSize cells, allocated only for the regions actually filled, instead
+ * of incrementing the DAMM matrix at random places for each count. On
+ * Flush() the tiles are scanned in order and the non zero cells are
+ * added with their weights to the DAMM matrix, which remains the
+ * storage exported to the .his file.
+ *
+ * When more than a fraction of all the tiles is in use the histogram is
+ * not sparse: it is flushed and promoted, from then on the counts go
+ * directly to the DAMM matrix.
+ *
+ * Owned by PlotsRegister, flushed at the end of each spill and at the
+ * end of the run.*/
+class SparseHistogram {
+public:
+    /** dammId is the absolute DAMM id, xSize and ySize the number of
+     * channels on each axis (before contraction) */
+    SparseHistogram(int dammId, int xSize, int ySize);
+
+    /** Adds weight to the cell (x, y) */
+    void Fill(int x, int y, int weight = 1) {
+        if (promoted_ || x < 0 || x >= xSize_ || y < 0 || y >= ySize_) {
+            FillDirect(x, y, weight);
+            return;
+        }
+        int tile = (y >> tileBits) * xTiles_ + (x >> tileBits);
+        int slot = tiles_[tile];
+        if (slot < 0) {
+            slot = NewTile(tile);
+            if (slot < 0) {
+                FillDirect(x, y, weight);
+                return;
+            }
+        }
+        counts_[(slot << (2 * tileBits)) +
+                ((y & tileMask) << tileBits) + (x & tileMask)] += weight;
+    }
+
+    /** Sets the cell (x, y) to value as set2cc does, dropping the counts
+     * collected for it */
+    void Set(int x, int y, int value);
+
+    /** Adds collected counts to the DAMM matrix */
+    void Flush();
+
+    /** True once the histogram is filled directly */
+    bool Promoted() const {
+        return promoted_;
+    }
+
+private:
+    static const int tileBits = 6;
+    static const int tileSize = 1 << tileBits;
+    static const int tileMask = tileSize - 1;
+
+    void FillDirect(int x, int y, int weight) const;
+
+    /** Allocates the tile and returns its slot in counts_, or flushes
+     * and promotes the histogram if the fill threshold is passed and
+     * returns -1 */
+    int NewTile(int tile);
+
+    int dammId_;
+    int xSize_;
+    int ySize_;
+    int xTiles_;
+    /** Number of tiles in use above which the histogram is promoted */
+    unsigned maxTiles_;
+    bool promoted_;
+    /** Slot of each tile in counts_, -1 if not in use */
+    std::vector<int> tiles_;
+    /** Tiles in use, by slot */
+    std::vector<int> used_;
+    /** Counts of the tiles in use, tileSize * tileSize per slot */
+    std::vector<int> counts_;
+};
+
+#endif // __SPARSEHISTOGRAM_HPP_
@@ -0,0 +1,57 @@
+/** \file SpillCounts.hpp
+ *
+ * Counts of histogram cells collected during a spill
+ */
+
+#ifndef __SPILLCOUNTS_HPP_
+#define __SPILLCOUNTS_HPP_
+
+#include <vector>
+
+/** Dense counters of the cells [0, size) of one or more histograms,
+ * filled during a spill and written with weights once at its end instead
+ * of one DAMM call per count. The touched cells are listed so that adding
+ * is constant time and the flush visits only the cells counted.*/
+class SpillCounts {
+public:
+    SpillCounts(unsigned size = 0) : counts_(size, 0) {}
+
+    /** Resizes the counters, dropping all counts */
+    void Resize(unsigned size) {
+        touched_.clear();
+        counts_.assign(size, 0);
+    }
+
+    unsigned Size() const {
+        return counts_.size();
+    }
+
+    /** Counts the cell, which must be below Size() */
+    void Add(unsigned cell) {
+        if (counts_[cell]++ == 0)
+            touched_.push_back(cell);
+    }
+
+    /** Cells counted since the last Clear(), in order of first count */
+    const std::vector<unsigned>& Touched() const {
+        return touched_;
+    }
+
+    unsigned operator[](unsigned cell) const {
+        return counts_[cell];
+    }
+
+    /** Zeroes the touched cells */
+    void Clear() {
+        for (std::vector<unsigned>::const_iterator it = touched_.begin();
+             it != touched_.end(); ++it)
+            counts_[*it] = 0;
+        touched_.clear();
+    }
+
+private:
+    std::vector<unsigned> counts_;
+    std::vector<unsigned> touched_;
+};
+
+#endif // __SPILLCOUNTS_HPP_
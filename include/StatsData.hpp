@@ -1,24 +1,116 @@
 #ifndef __STATS_DATA_HPP
 #define __STATS_DATA_HPP
 
+#include "pixie16app_defs.h"
+#include "Globals.hpp"
+
+/** Statistics blocks inserted in the data stream by the poll program.
+ *
+ * Besides the raw DSP words, each block is decoded per channel (real time,
+ * live time, fast peaks and output counts) and the change since the
+ * previous block of the module gives the input rate (fast peaks over live
+ * time), the output rate (output counts over real time) and the dead time
+ * fraction 1 - output / input of the last interval and of the whole run.
+ * The correction factor of a channel is input / output, i.e. the number
+ * of true counts represented by one recorded count.
+ *
+ * The channel id is module * NUMBER_OF_CHANNELS + channel, as the index
+ * of the DetectorLibrary. Before two blocks of a module are seen the
+ * fractions are 0 and the correction 1.*/
 class StatsData {
+public:
+    /** Counters of a channel, times in seconds */
+    struct Counters {
+        double realTime;
+        double liveTime;
+        double fastPeaks;
+        double outCounts;
+    };
+
 private:
     static const size_t statSize = N_DSP_PAR - DSP_IO_BORDER;
     static const size_t maxVsn = 14;
+    static const size_t maxId = maxVsn * NUMBER_OF_CHANNELS;
 
     double firstTime; /**< Store the time of the first statistics block */
+    unsigned blocks;  /**< Number of (changed) statistics blocks */
     pixie::word_t oldData[maxVsn][statSize]; /**< Older statistics data to calculate the change in statistics */
     pixie::word_t data[maxVsn][statSize];    /**< Statistics data from each module */
+
+    Counters current[maxId];   /**< Counters of the last block */
+    Counters interval[maxId];  /**< Change between the two last blocks */
+    Counters total[maxId];     /**< Sum of the valid intervals */
+    bool hasInterval[maxId];   /**< True if interval is valid */
+
+    /** Counter of the module split in a high and a low word */
+    double Word64(unsigned int mod, size_t posHi, size_t posLo) const {
+        return data[mod][posHi] * 4294967296.0 + data[mod][posLo];
+    }
+
+    /** Decodes the counters of all channels of the module */
+    void Decode(unsigned int mod);
+
+    /** 1 - output / input rate of the counters, 0 if undefined */
+    static double DeadFraction(const Counters& c);
+
 public:
     static const pixie::word_t headerLength = 1;
 
     StatsData(void);
-    void DoStatisticsBlock(pixie::word_t *buf, int vsn);
+    /** Stores the block of module vsn, returns true if it changed */
+    bool DoStatisticsBlock(pixie::word_t *buf, int vsn);
 
     double GetCurrTime(unsigned int id) const;
     double GetDiffPeaks(unsigned int id) const;
     double GetDiffTime(unsigned int id) const;
     double GetRealTime(unsigned int mod = 0) const;
+
+    /** Real time of the first statistics block, NaN before it */
+    double GetFirstTime() const {
+        return firstTime;
+    }
+
+    /** Number of statistics blocks which changed the statistics */
+    unsigned GetBlockCount() const {
+        return blocks;
+    }
+
+    /** True if the id is in range and the last interval is valid */
+    bool HasInterval(unsigned int id) const {
+        return id < maxId && hasInterval[id];
+    }
+
+    /** Counters of the last block, the last interval and the run,
+     * the id must be below maxVsn * NUMBER_OF_CHANNELS */
+    const Counters& GetCounters(unsigned int id) const {
+        return current[id];
+    }
+    const Counters& GetInterval(unsigned int id) const {
+        return interval[id];
+    }
+    const Counters& GetTotal(unsigned int id) const {
+        return total[id];
+    }
+
+    /** Fast peaks over live time of the last interval (1/s) */
+    double GetInputRate(unsigned int id) const;
+    /** Output counts over real time of the last interval (1/s) */
+    double GetOutputRate(unsigned int id) const;
+    /** Live over real time of the last interval */
+    double GetLiveFraction(unsigned int id) const;
+    /** Fraction of the input counts lost in the last interval */
+    double GetDeadFraction(unsigned int id) const;
+    /** Fraction of the input counts lost since the first block */
+    double GetTotalDeadFraction(unsigned int id) const;
+    /** Input over output counts of the last interval, multiplies the
+     * counts of the channel to correct for the dead time (infinite if
+     * nothing was recorded out of a non zero input) */
+    double GetCorrection(unsigned int id) const;
+    /** As GetCorrection, over the whole run */
+    double GetTotalCorrection(unsigned int id) const;
 };
 
+/** Statistics of the run, filled by ReadBuffData */
+extern StatsData stats;
+
 #endif
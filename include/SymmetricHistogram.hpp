@@ -0,0 +1,60 @@
+/** \file SymmetricHistogram.hpp
+ *
+ * Accumulation of symmetric 2D (gamma-gamma) plots
+ */
+
+#ifndef __SYMMETRICHISTOGRAM_HPP_
+#define __SYMMETRICHISTOGRAM_HPP_
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+/** Collects the pairs of a symmetric matrix in its upper triangle, one
+ * entry per pair (min, max) instead of plotting both (x, y) and (y, x).
+ * On Flush() the pairs are sorted, equal cells are merged and the counts
+ * are written once to each half of the DAMM matrix, which remains the
+ * mirrored view used for projections and the .his output (cells on the
+ * diagonal get both increments, as before).
+ *
+ * Owned by PlotsRegister, flushed at the end of each spill, when the
+ * buffer is full and at the end of the run.*/
+class SymmetricHistogram {
+public:
+    /** dammId is the absolute DAMM id, size the number of channels
+     * on each axis (before contraction) */
+    SymmetricHistogram(int dammId, int size);
+
+    /** Adds pair of values */
+    void Fill(double val1, double val2) {
+        int x = int(val1);
+        int y = int(val2);
+        if (x > y) {
+            int t = x;
+            x = y;
+            y = t;
+        }
+        if (x < 0 || y >= size_) {
+            /** Out of range values are passed to DAMM as they are */
+            FillDirect(x, y);
+            return;
+        }
+        pairs_.push_back(uint32_t(x) * size_ + uint32_t(y));
+        if (pairs_.size() == capacity_)
+            Flush();
+    }
+
+    /** Writes collected pairs into the DAMM matrix */
+    void Flush();
+
+private:
+    void FillDirect(int x, int y) const;
+
+    int dammId_;
+    int size_;
+    size_t capacity_;
+    /** Upper triangle cells, x * size + y with x <= y */
+    std::vector<uint32_t> pairs_;
+};
+
+#endif // __SYMMETRICHISTOGRAM_HPP_
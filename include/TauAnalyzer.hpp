@@ -21,6 +21,11 @@ class TauAnalyzer : public TraceAnalyzer
 
     ~TauAnalyzer();
     virtual void Analyze(Trace &trace, const std::string &aType, const std::string &aSubtype);
+    virtual bool Accepts(const std::string &aType,
+                         const std::string &aSubtype) const {
+        return !(type != "" && subtype != "" &&
+                 type != aType && subtype != aSubtype);
+    }
 };
 
 #endif // __TAUANALYZER_HPP_
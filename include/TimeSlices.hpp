@@ -0,0 +1,167 @@
+/** \file TimeSlices.hpp
+ *
+ * Snapshots of selected histograms over time intervals of the run
+ */
+
+#ifndef __TIMESLICES_HPP_
+#define __TIMESLICES_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/** Singleton keeping, besides the cumulative DAMM histograms, the counts
+ * of selected histograms in the current time slice of the run. At the
+ * end of each slice the non empty cells are written to a file and
+ * compared with the previous slice, so gain drifts, rate changes and
+ * dead detectors show up during the run instead of requiring to scan it
+ * again with time gates.
+ *
+ * Configured by the optional section
+ * \code
+ * <TimeSlices file="slices.bin" interval="60" clock="pixie|wall|cycle"
+ *             rate_change="0.5" mean_shift="5">
+ *     <Histogram id="3100"/>
+ * </TimeSlices>
+ * \endcode
+ * The ids are the absolute DAMM ids. The interval is in seconds of the
+ * Pixie clock (pixie, default) or of the wall clock (wall), or in number
+ * of tape cycles (cycle). At the end of each slice a warning is given
+ * for the histograms whose counting rate changed by more than the
+ * rate_change fraction, or whose mean x moved by more than mean_shift
+ * channels, with respect to the previous slice (0 or missing disables).
+ *
+ * The fills through Plots::Plot, PlotWeighted, PlotSymmetric and
+ * PlotGranularY are sliced, counted as DAMM counts them. Plot calls
+ * setting a cell (2D with a weight) are not sliced, a slice only holds
+ * increments. A fill is credited to the slice open when it is made:
+ * the counts accumulated over a spill and plotted at its end (the
+ * statistics spectra of PlotWeighted) all go to the slice of the last
+ * event of the spill, even if the spill crossed a slice boundary.
+ * Without the section the only cost is the inline check of the Plots on
+ * each plot.
+ *
+ * The file starts with the magic "PXSLICE1" and the version (uint32),
+ * each slice is a record of index (uint32), start and stop (double),
+ * number of histograms (uint32), then for each histogram its id, number
+ * of cells (uint32) and the cells as x, y, counts (int32, y = 0 for 1D).*/
+class TimeSlices {
+public:
+    /** Returns only instance of TimeSlices class.*/
+    static TimeSlices* get();
+
+    /** True if the slices are configured, valid after the first get() */
+    static bool enabled() {
+        return enabled_;
+    }
+
+    /** Non empty cell of a histogram slice */
+    struct Cell {
+        int x;
+        int y;
+        int counts;
+    };
+
+    /** Counts of the sliced histograms in a time interval, cells are
+     * sorted by (y, x) */
+    struct Snapshot {
+        unsigned index;
+        double start;
+        double stop;
+        std::map<int, std::vector<Cell> > histograms;
+    };
+
+    /** Slot of the histogram of absolute dammId (dims 1 or 2) if it is
+     * sliced, -1 otherwise. Called by Plots on declaration. */
+    int Slot(int dammId, int dims);
+
+    /** Adds a fill of the slot, arguments as in Plots::Plot. As in DAMM
+     * a 1D fill adds 1 to val1 and a 2D fill adds 1 to (val1, val2), or
+     * to (val1, 1) without val2. A 2D fill with a weight val3 sets the
+     * cell and is not sliced. */
+    void Fill(int slot, double val1, double val2, double val3) {
+        if (histograms_[slot].dims == 1)
+            Add(slot, int(val1), 0, 1);
+        else if (val2 == -1 && val3 == -1)
+            Add(slot, int(val1), 1, 1);
+        else if (val3 == -1 || val3 == 0)
+            Add(slot, int(val1), int(val2), 1);
+    }
+
+    /** Adds weight to the cell (x, y) of the slot, y is ignored for 1D */
+    void Add(int slot, int x, int y, int weight) {
+        Histogram& h = histograms_[slot];
+        Cell c;
+        c.x = x;
+        c.y = (h.dims == 1) ? 0 : y;
+        c.counts = weight;
+        h.fills.push_back(c);
+        if (h.fills.size() >= h.capacity)
+            Compact(h);
+    }
+
+    /** Moves to the slice of the event at the Pixie time, ending the
+     * current slice if needed. Called by DetectorDriver for each event. */
+    void Advance(double time);
+
+    /** Ends the current slice, also called at exit */
+    void EndSlice();
+
+    /** Last complete slice (index 0 and empty before the first one) */
+    const Snapshot& Previous() const {
+        return previous_;
+    }
+
+    /** Cells of b minus cells of a for each histogram of b */
+    static void Diff(const Snapshot& a, const Snapshot& b, Snapshot& diff);
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    TimeSlices();
+    /* Do not implement*/
+    TimeSlices(TimeSlices const&);
+    void operator=(TimeSlices const&);
+    static TimeSlices* instance;
+    static bool enabled_;
+
+    static void EndAtExit();
+
+    enum Clock {PIXIE, WALL, CYCLE};
+
+    struct Histogram {
+        int dammId;
+        int dims;
+        /** Fills of the slice, compacted to sorted cells when full */
+        std::vector<Cell> fills;
+        size_t capacity;
+    };
+
+    /** Sorts and merges the fills to one entry per cell */
+    static void Compact(Histogram& h);
+
+    /** Position of the time in slices */
+    double SlicePosition(double time) const;
+
+    /** Warns about the histograms changed with respect to previous_ */
+    void CompareSlices(const Snapshot& current) const;
+
+    std::vector<int> ids_;
+    std::vector<Histogram> histograms_;
+    Snapshot previous_;
+    Clock clock_;
+    double interval_;
+    double rateChange_;
+    double meanShift_;
+    bool started_;
+    unsigned index_;
+    double sliceStart_;
+    double lastTime_;
+    std::string file_name_;
+
+    /** Increase whenever the layout of the file changes */
+    static const uint32_t version_ = 1;
+};
+
+#endif // __TIMESLICES_HPP_
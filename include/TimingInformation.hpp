@@ -8,20 +8,23 @@
 #define __TIMINGINFORMATION_HPP_
 
 #include <map>
-
-#ifdef useroot
-#include "Rtypes.h"
-#endif
+#include <string>
+#include <vector>
 
 // Forward declarations for hell of circular dependencies
 // see Trace.hpp
 class Trace;
 // see ChanEvent.hpp
 class ChanEvent;
+// see ColumnFile.hpp
+class ColumnWriter;
 
 class TimingInformation
 {
  public:
+    /** Kinds of VANDLE bars, index of the per type tables */
+    enum BarType {SMALL_BAR = 0, BIG_BAR = 1, NUM_BAR_TYPES = 2};
+
     struct TimingCal {
         double lrtOffset;
         double r0;
@@ -36,7 +39,9 @@ class TimingInformation
     {
         TimingData(void);
         TimingData(ChanEvent *chan);
-        const Trace &trace;
+        /** Pointer rather than reference, so the data can be kept in
+         * tables and reassigned */
+        const Trace *trace;
         
         bool dataValid;
         
@@ -53,36 +58,39 @@ class TimingInformation
         double walkCorTime;
     };
     
-#ifdef useroot
+    /** Per event timing data of a group of detectors, for the ROOT
+     * branches and the columnar output */
     struct DataRoot
     {
         static const size_t maxMultiplicity = 10;
 
         DataRoot(void);
+        /** Binds the fields to columns named prefix_field, the arrays to
+         * prefix_field0 ... prefix_field9 */
+        void AddColumns(ColumnWriter *writer, const std::string &prefix);
 
-        UInt_t   multiplicity;
-        UInt_t   dummy;
-
-        Double_t aveBaseline[maxMultiplicity];
-        Double_t discrimination[maxMultiplicity];
-        Double_t highResTime[maxMultiplicity];
-        Double_t maxpos[maxMultiplicity];
-        Double_t maxval[maxMultiplicity];
-        Double_t phase[maxMultiplicity];
-        Double_t stdDevBaseline[maxMultiplicity];
-        Double_t tqdc[maxMultiplicity];
-        UInt_t   location[maxMultiplicity];
+        unsigned int multiplicity;
+        unsigned int dummy;
+
+        double aveBaseline[maxMultiplicity];
+        double discrimination[maxMultiplicity];
+        double highResTime[maxMultiplicity];
+        double maxpos[maxMultiplicity];
+        double maxval[maxMultiplicity];
+        double phase[maxMultiplicity];
+        double stdDevBaseline[maxMultiplicity];
+        double tqdc[maxMultiplicity];
+        unsigned int location[maxMultiplicity];
     };
-#endif
 
     struct BarData
     {
+        BarData(void) : event(false) {}
         BarData(const TimingData& Right, const TimingData& Left, 
-            const TimingCal &cal, const std::string &type);
-        bool BarEventCheck(const double &timeDiff, 
-                const std::string &type);
+            const TimingCal &cal, BarType type);
+        bool BarEventCheck(const double &timeDiff, BarType type);
             double CalcFlightPath(double &timeDiff, const TimingCal &cal, 
-                    const std::string &type);
+                    BarType type);
         
             bool event;
         
@@ -96,9 +104,10 @@ class TimingInformation
         double timeDiff;
         double walkCorTimeDiff;
         
-        std::map<unsigned int, double> timeOfFlight;
-        std::map<unsigned int, double> corTimeOfFlight;
-        std::map<unsigned int, double> energy;
+        /** Indexed by the slot of the start detector */
+        std::vector<double> timeOfFlight;
+        std::vector<double> corTimeOfFlight;
+        std::vector<double> energy;
     };
 
     //define types for the keys and maps
@@ -112,6 +121,14 @@ class TimingInformation
     
     static double GetConstant(const std::string &value);
     static TimingCal GetTimingCal(const IdentKey &identity);
+
+    /** Calibration of the bar of a given type at location, from the flat
+     * tables filled by ReadTimingCalibration (no string lookup) */
+    static const TimingCal& GetBarCal(BarType type, unsigned int location) {
+        if (location >= barCal_[type].size() || !hasBarCal_[type][location])
+            MissingBarCal(type, location);
+        return barCal_[type][location];
+    }
     static void ReadTimingCalibration(void);
     static void ReadTimingConstants(void);
     
@@ -120,5 +137,17 @@ class TimingInformation
 
     static std::map<std::string, double> constantsMap;
     static TimingCalMap calibrationMap;
+
+    /** Constants used per bar and per event, cached by ReadTimingConstants */
+    static double lengthTime_[NUM_BAR_TYPES];
+    static double speedOfLightBar_[NUM_BAR_TYPES];
+    static double speedOfLight_;
+    static double neutronMass_;
+
+    /** Bar calibrations indexed by location, for each bar type */
+    static std::vector<TimingCal> barCal_[NUM_BAR_TYPES];
+    static std::vector<bool> hasBarCal_[NUM_BAR_TYPES];
+
+    static void MissingBarCal(BarType type, unsigned int location);
 }; // class TimingInformation
 #endif //__TIMINGINFORMATION_HPP_
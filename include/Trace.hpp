@@ -12,6 +12,7 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <stdint.h>
 
 #include "DammPlotIds.hpp"
 #include "Globals.hpp"
@@ -44,6 +45,27 @@ class Trace : public std::vector<int> // in the structure of std::vector<int> by
     std::map<std::string, double> doubleTraceData;
     std::map<std::string, int>    intTraceData;
 
+    /** Channel id and time stamp of the hit, see SetHit() */
+    unsigned hitId_;
+    uint64_t hitTime_;
+
+    /** Packed 16-bit samples read while the int samples are empty, see
+     * SetPacked() */
+    const std::vector<pixie::halfword_t>* packed_;
+
+    /** Running sums of the samples and of their squares, element i holds
+     * the sum over the first i samples. Built on the first window query
+     * and shared by all the analyzers of the trace. */
+    mutable std::vector<int64_t> sums_;
+    mutable std::vector<int64_t> squareSums_;
+
+    /** Builds the running sums if they do not match the trace length */
+    void CheckSums() const {
+        if (sums_.size() != NumSamples() + 1)
+            BuildSums();
+    }
+    void BuildSums() const;
+
     /** This field is static so all instances of Trace class have access to 
      * the same plots and plots range. */
     static Plots histo; 
@@ -52,15 +74,78 @@ class Trace : public std::vector<int> // in the structure of std::vector<int> by
      
     Trace() : std::vector<int>() {
         baselineLow = baselineHigh = pixie::U_DELIMITER;
+        hitId_ = 0;
+        hitTime_ = 0;
+        packed_ = NULL;
     }
     // an automatic conversion
     Trace(const std::vector<int> &x) : std::vector<int>(x) {
         baselineLow = baselineHigh = pixie::U_DELIMITER;
+        hitId_ = 0;
+        hitTime_ = 0;
+        packed_ = NULL;
+    }
+
+    /** Lets the trace read the packed samples of the channel in place of
+     * its int samples as long as these are empty, NULL to stop. Only the
+     * Trace methods and Sample()/NumSamples() see the packed samples. */
+    void SetPacked(const std::vector<pixie::halfword_t>* packed) {
+        packed_ = packed;
+    }
+    /** Number of samples, packed or expanded */
+    size_type NumSamples() const {
+        return (packed_ != NULL && empty()) ? packed_->size() : size();
+    }
+    /** Sample i, packed or expanded */
+    int Sample(size_type i) const {
+        return (packed_ != NULL && empty()) ? (*packed_)[i] : (*this)[i];
+    }
+
+    /** Identifies the hit the trace belongs to, set before the trace
+     * analysis so analyzers can draw reproducible random numbers
+     * (RandomPool) */
+    void SetHit(unsigned id, uint64_t time) {
+        hitId_ = id;
+        hitTime_ = time;
+    }
+    unsigned GetHitId() const {
+        return hitId_;
+    }
+    uint64_t GetHitTime() const {
+        return hitTime_;
+    }
+
+    /** Builds the running sums ahead of the analysis, may be called for
+     * different traces in parallel (see WorkerPool) */
+    void PrepareSums() const {
+        CheckSums();
+    }
+    /** Sum of the samples in [lo, hi), hi must not exceed NumSamples() */
+    int64_t WindowSum(unsigned int lo, unsigned int hi) const {
+        CheckSums();
+        return sums_[hi] - sums_[lo];
+    }
+    /** Mean of the samples in [lo, hi) */
+    double WindowMean(unsigned int lo, unsigned int hi) const {
+        return double(WindowSum(lo, hi)) / (hi - lo);
+    }
+    /** Variance (not corrected for the degrees of freedom) of the
+     * samples in [lo, hi) */
+    double WindowVariance(unsigned int lo, unsigned int hi) const {
+        double mean = WindowMean(lo, hi);
+        return double(squareSums_[hi] - squareSums_[lo]) / (hi - lo) -
+               mean * mean;
+    }
+    /** Drops the running sums, needed only if samples are changed in place
+     * without changing the length of the trace */
+    void ResetSums() {
+        sums_.clear();
+        squareSums_.clear();
     }
 
     void TrapezoidalFilter(Trace &filter, const TFP &parms,
 			   unsigned int lo = 0) const {
-        TrapezoidalFilter( filter, parms, lo, size() );
+        TrapezoidalFilter( filter, parms, lo, NumSamples() );
     }
     void TrapezoidalFilter(Trace &filter, const TFP &parms,
 			   unsigned int lo, unsigned int hi) const;
@@ -100,6 +185,14 @@ class Trace : public std::vector<int> // in the structure of std::vector<int> by
     return NAN;
     }
 
+    /** All values set by the trace analyzers */
+    const std::map<std::string, double>& GetDoubleValues() const {
+        return doubleTraceData;
+    }
+    const std::map<std::string, int>& GetIntValues() const {
+        return intTraceData;
+    }
+
     //To allow access to the variables related to timing
     //This is needed in order to calculate the baseline over the 
     //range that immediately preceedes the trace. -SVP
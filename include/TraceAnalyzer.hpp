@@ -42,6 +42,18 @@ class TraceAnalyzer {
     virtual void DeclarePlots(void);
     virtual void Analyze(Trace &trace, 
 			 const std::string &type, const std::string &subtype);
+    /** Returns true if traces of the given type and subtype are analyzed,
+     *  used to resolve the analyzers of each channel once at startup */
+    virtual bool Accepts(const std::string &,
+                         const std::string &) const {
+        return true;
+    }
+    /** Returns true if Analyze reads the samples only through
+     *  Trace::Sample(), NumSamples() and the Trace methods, so the packed
+     *  samples of the channel do not need to be expanded */
+    virtual bool ReadsPacked() const {
+        return false;
+    }
     void EndAnalyze(Trace &trace);
     void EndAnalyze(void);
     void SetLevel(int i) {level=i;}
@@ -29,6 +29,13 @@ class TraceExtracter : public TraceAnalyzer {
     virtual void DeclarePlots(void);
     virtual void Analyze(Trace &trace, 
 			 const std::string &type, const std::string &subtype);
+    virtual bool ReadsPacked() const {
+        return true;
+    }
+    virtual bool Accepts(const std::string &aType,
+                         const std::string &aSubtype) const {
+        return (type == aType && subtype == aSubtype);
+    }
 };
 
 #endif // __TRACEEXTRACTER_HPP_
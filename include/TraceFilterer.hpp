@@ -22,6 +22,9 @@ class TraceFilterer : public TraceAnalyzer {
 
         virtual bool Init(const std::string &filterFileName = "filter.txt");
         virtual void DeclarePlots(void);
+        virtual bool ReadsPacked() const {
+            return true;
+        }
         virtual void Analyze(Trace &trace, 
                 const std::string &type, const std::string &subtype);
     protected:    
@@ -55,6 +58,10 @@ class TraceFilterer : public TraceAnalyzer {
 
         PulseInfo pulse; 
 
+        /** Hit of the analyzed trace, keys the dithering randoms */
+        unsigned hitId_;
+        uint64_t hitTime_;
+
         virtual const PulseInfo& FindPulse(Trace::iterator begin, 
                                         Trace::iterator end);
 };
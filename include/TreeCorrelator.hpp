@@ -5,6 +5,7 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <vector>
 #include "pugixml.hpp"
 #include "Places.hpp"
 #include "PlaceBuilder.hpp"
@@ -31,6 +32,21 @@ class TreeCorrelator {
         /** Return pointer to place or throw exception if it doesn't exist. */
         Place* place(std::string name);
 
+        /** Return handle of the place or throw exception if it doesn't
+         * exist. Handles do not change during the run (also if place is
+         * replaced), resolve them once and use place(unsigned) per event
+         * instead of the lookup by name.*/
+        unsigned handle(const std::string& name) const;
+
+        /** Return pointer to place of a given handle. */
+        Place* place(unsigned handle) const {
+            return placeList_[handle];
+        }
+
+        /** Reset resetable places that changed state in the current
+         * event. Call at the end of each event.*/
+        void resetPlaces();
+
         /** Create place, alter or add existing place to the tree. */
         void createPlace(std::map<std::string, std::string>& params,
                          bool verbose);
@@ -60,6 +76,11 @@ class TreeCorrelator {
 
         static PlaceBuilder builder;
 
+        /** Places indexed by handle */
+        std::vector<Place*> placeList_;
+        /** Handles of places by name */
+        std::map<std::string, unsigned> handles_;
+
         /** Splits name string into the vector of string. Assumes that if
          * the last token (delimiter being "_") is in format "X-Y,Z" where
          * X, Y are integers, the X and Y are range of base names to be retured
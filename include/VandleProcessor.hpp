@@ -6,6 +6,8 @@
 #ifndef __VANDLEPROCESSOR_HPP_
 #define __VANDLEPROCESSOR_HPP_
 
+#include <vector>
+
 #include "EventProcessor.hpp"
 #include "TimingInformation.hpp"
 
@@ -18,12 +20,32 @@ class VandleProcessor : public EventProcessor,
     virtual bool Process(RawEvent &event);
      
  protected:
-    //define the maps
-    BarMap  barMap; 
-    TimingDataMap bigMap;
-    TimingDataMap smallMap;
-    TimingDataMap startMap;
-    TimingDataMap tvandleMap;
+    /** Sides of a bar, ends are stored at 2*location + side */
+    enum BarSide {RIGHT = 0, LEFT = 1};
+
+    /** Ends and bars of one kind of bar, sized once from the
+     * DetectorLibrary; only the touched locations are cleared */
+    struct BarTable {
+        std::vector<TimingData> ends;
+        std::vector<bool> hasEnd;
+        std::vector<BarData> bars;
+        /** Locations with at least one end in the event */
+        std::vector<unsigned int> touched;
+        /** Locations with a bar in the event, in increasing order */
+        std::vector<unsigned int> built;
+
+        void Resize(unsigned int numLocations);
+        void Clear(void);
+    };
+
+    BarTable barTables[NUM_BAR_TYPES];
+    BarTable tvandleTable;
+
+    /** Start detectors stored at 2*location + (0 beta, 1 liquid) */
+    std::vector<TimingData> starts;
+    std::vector<bool> hasStart;
+    /** Slots of the starts in the event, in increasing order */
+    std::vector<unsigned int> startSlots;
 
  private:
     virtual bool RetrieveData(RawEvent &event);
@@ -33,20 +55,17 @@ class VandleProcessor : public EventProcessor,
 			      const double &z0) {return((z0/corRadius)*TOF);};
 
     virtual void AnalyzeData(RawEvent& rawev);
-    virtual void BuildBars(const TimingDataMap &endMap, const std::string &type, 
-			   BarMap &barMap);
+    virtual void AnalyzeBars(RawEvent& rawev, BarType type);
+    virtual void BuildBars(BarTable &table, BarType type);
     virtual void ClearMaps(void);
     virtual void CrossTalk(void);
-    virtual void FillMap(const std::vector<ChanEvent*> &eventList, const std::string type,
-			 TimingDataMap &eventMap);
+    virtual void FillEnds(const std::vector<ChanEvent*> &eventList,
+			  unsigned int offset, BarTable &table);
+    virtual void FillStarts(const std::vector<ChanEvent*> &eventList);
     virtual void Tvandle(void);
 
     bool hasDecay;
     double decayTime;
     int counter;
-
-    typedef std::pair<unsigned int, unsigned int> CrossTalkKey; 
-    typedef std::map<CrossTalkKey, double> CrossTalkMap;
-    std::map<CrossTalkKey, double> crossTalk;
 }; //Class VandleProcessor
 #endif // __VANDLEPROCESSOR_HPP_
@@ -13,8 +13,12 @@ class TTree;
 class VandleROOT : public VandleProcessor
 {
  public: 
+    bool AddColumns(ColumnWriter *writer);
+    void FillColumns(void);
+#ifdef useroot
     bool AddBranch(TTree *tree);
     void FillBranch(void);
+#endif
 
  private:
     DataRoot smallRight;
@@ -25,6 +29,8 @@ class VandleROOT : public VandleProcessor
     bool isSmall;
     bool isBig;
 
-    virtual void FillRoot(const TimingDataMap &endMap, const std::string &barType);
+    /** Clears the data and fills it with the bars of the event */
+    void FillData(void);
+    virtual void FillRoot(const BarTable &table, BarType barType);
 }; // class VandleROOT
 #endif // __VANDLEROOT_HPP_
@@ -16,6 +16,13 @@ class WaveformAnalyzer : public TraceAnalyzer
         virtual void DeclarePlots(void) const;
         virtual void Analyze(Trace &, const std::string &,
                 const std::string &);
+        /** Only the timing detectors have their waveform analyzed */
+        virtual bool Accepts(const std::string &detType,
+                             const std::string &) const {
+            return (detType == "vandleSmall" || detType == "vandleBig" 
+                    || detType == "liquid_scint" || detType == "pulser" 
+                    || detType == "tvandle");
+        }
         virtual ~WaveformAnalyzer() {};
     private:
         TimingInformation timing_;
@@ -0,0 +1,75 @@
+/** \file WorkerPool.hpp
+ *
+ * Pool of threads running data parallel stages of the spill analysis
+ */
+
+#ifndef __WORKERPOOL_HPP_
+#define __WORKERPOOL_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include <pthread.h>
+
+/** Singleton with a fixed number of worker threads, set by the
+ * <TraceThreads value="4"/> node of the Global section (1, the default,
+ * runs everything in the calling thread).
+ *
+ * Run() splits the range [0, n) into one contiguous part per thread, the
+ * caller working on the first part, and returns when all the parts are
+ * done. The task must only touch the items of its part and must not
+ * throw: no plotting, no shared counters.*/
+class WorkerPool {
+public:
+    /** Returns only instance of WorkerPool class.*/
+    static WorkerPool* get();
+
+    /** Work on the items [begin, end) of the context */
+    typedef void (*Task)(void* context, size_t begin, size_t end);
+
+    /** Runs task over [0, n) in parallel, returns when it is done */
+    void Run(Task task, void* context, size_t n);
+
+    /** Number of threads working on a Run(), the caller included */
+    unsigned Size() const {
+        return workers_.size() + 1;
+    }
+
+private:
+    /** Make constructor, copy-constructor and operator =
+        * private to complete singleton implementation.*/
+    WorkerPool();
+    /* Do not implement*/
+    WorkerPool(WorkerPool const&);
+    void operator=(WorkerPool const&);
+    static WorkerPool* instance;
+
+    struct Worker {
+        WorkerPool* pool;
+        unsigned part;
+        pthread_t thread;
+    };
+
+    static void* Work(void* worker);
+    static void StopAtExit();
+    void Loop(unsigned part);
+    /** Runs the part of the current task */
+    void RunPart(unsigned part);
+    void Stop();
+
+    std::vector<Worker> workers_;
+    Task task_;
+    void* context_;
+    size_t items_;
+    /** Increased for each Run(), workers wait for a new value */
+    unsigned long generation_;
+    /** Parts of the current Run() not finished yet */
+    unsigned pending_;
+    bool stop_;
+
+    pthread_mutex_t mutex_;
+    pthread_cond_t started_;
+    pthread_cond_t finished_;
+};
+
+#endif // __WORKERPOOL_HPP_
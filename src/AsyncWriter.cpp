@@ -0,0 +1,234 @@
+/** \file AsyncWriter.cpp
+ *
+ * Background thread writing the text and binary outputs
+ */
+#include <cstdlib>
+#include <sstream>
+
+#include "AsyncWriter.hpp"
+#include "Messenger.hpp"
+
+using namespace std;
+
+AsyncWriter* AsyncWriter::instance = NULL;
+
+/** Instance is created upon first call */
+AsyncWriter* AsyncWriter::get() {
+    if (!instance) {
+        instance = new AsyncWriter();
+    }
+    return instance;
+}
+
+AsyncWriter::AsyncWriter() {
+    capacity_ = 1024;
+    pushed_ = 0;
+    done_ = 0;
+    running_ = false;
+    errors_ = 0;
+
+    pthread_mutex_init(&mutex_, NULL);
+    pthread_cond_init(&notEmpty_, NULL);
+    pthread_cond_init(&notFull_, NULL);
+    pthread_cond_init(&jobsDone_, NULL);
+
+    if (pthread_create(&thread_, NULL, &AsyncWriter::Run, this) == 0) {
+        running_ = true;
+        atexit(&AsyncWriter::ShutdownAtExit);
+    }
+}
+
+void AsyncWriter::ShutdownAtExit() {
+    if (instance)
+        instance->Shutdown();
+}
+
+void* AsyncWriter::Run(void* self) {
+    static_cast<AsyncWriter*>(self)->Loop();
+    return NULL;
+}
+
+void AsyncWriter::Open(const string& file, bool truncate) {
+    Push(Job::OPEN, file, NULL, truncate);
+}
+
+void AsyncWriter::Write(const string& file, string& data) {
+    Push(Job::WRITE, file, &data);
+}
+
+void AsyncWriter::Flush() {
+    Push(Job::FLUSH, "");
+    Report();
+}
+
+void AsyncWriter::Close(const string& file) {
+    Push(Job::CLOSE, file);
+}
+
+void AsyncWriter::Sync() {
+    pthread_mutex_lock(&mutex_);
+    unsigned long target = pushed_;
+    while (running_ && done_ < target)
+        pthread_cond_wait(&jobsDone_, &mutex_);
+    pthread_mutex_unlock(&mutex_);
+}
+
+void AsyncWriter::Shutdown() {
+    pthread_mutex_lock(&mutex_);
+    bool running = running_;
+    pthread_mutex_unlock(&mutex_);
+    if (!running) {
+        Report();
+        return;
+    }
+
+    Push(Job::STOP, "");
+    pthread_join(thread_, NULL);
+    pthread_mutex_lock(&mutex_);
+    running_ = false;
+    pthread_mutex_unlock(&mutex_);
+    Report();
+}
+
+void AsyncWriter::Report() {
+    pthread_mutex_lock(&mutex_);
+    string error = error_;
+    unsigned long errors = errors_;
+    error_.clear();
+    errors_ = 0;
+    pthread_mutex_unlock(&mutex_);
+    if (errors == 0)
+        return;
+
+    stringstream ss;
+    ss << error;
+    if (errors > 1)
+        ss << " (and " << errors - 1 << " more error(s))";
+    Messenger m;
+    m.warning(ss.str());
+}
+
+void AsyncWriter::Push(Job::Kind kind, const string& file, string* data,
+                       bool truncate) {
+    pthread_mutex_lock(&mutex_);
+    if (!running_) {
+        pthread_mutex_unlock(&mutex_);
+        Job job;
+        job.kind = kind;
+        job.truncate = truncate;
+        job.file = file;
+        if (data != NULL)
+            job.data.swap(*data);
+        Execute(job);
+        return;
+    }
+
+    while (queue_.size() >= capacity_)
+        pthread_cond_wait(&notFull_, &mutex_);
+
+    queue_.push_back(Job());
+    Job& job = queue_.back();
+    job.kind = kind;
+    job.truncate = truncate;
+    job.file = file;
+    if (data != NULL)
+        job.data.swap(*data);
+    ++pushed_;
+
+    pthread_cond_signal(&notEmpty_);
+    pthread_mutex_unlock(&mutex_);
+}
+
+void AsyncWriter::Loop() {
+    deque<Job> batch;
+    bool stop = false;
+    while (!stop) {
+        /** Take all queued jobs at once and release the lock while
+         * writing */
+        pthread_mutex_lock(&mutex_);
+        while (queue_.empty())
+            pthread_cond_wait(&notEmpty_, &mutex_);
+        batch.swap(queue_);
+        pthread_cond_broadcast(&notFull_);
+        pthread_mutex_unlock(&mutex_);
+
+        for (deque<Job>::iterator it = batch.begin();
+             it != batch.end(); ++it) {
+            if (it->kind == Job::STOP) {
+                stop = true;
+                break;
+            }
+            Execute(*it);
+        }
+
+        pthread_mutex_lock(&mutex_);
+        done_ += batch.size();
+        pthread_cond_broadcast(&jobsDone_);
+        pthread_mutex_unlock(&mutex_);
+        batch.clear();
+    }
+
+    for (map<string, ofstream*>::iterator it = sinks_.begin();
+         it != sinks_.end(); ++it) {
+        it->second->close();
+        delete it->second;
+    }
+    sinks_.clear();
+}
+
+void AsyncWriter::Execute(Job& job) {
+    string error;
+    switch (job.kind) {
+        case Job::OPEN:
+        case Job::WRITE: {
+            map<string, ofstream*>::iterator sink = sinks_.find(job.file);
+            if (job.kind == Job::OPEN && sink != sinks_.end()) {
+                sink->second->close();
+                delete sink->second;
+                sinks_.erase(sink);
+                sink = sinks_.end();
+            }
+            if (sink == sinks_.end()) {
+                ios::openmode mode = ios::out | ios::binary;
+                mode |= job.truncate ? ios::trunc : ios::app;
+                ofstream* out = new ofstream(job.file.c_str(), mode);
+                if (!out->good()) {
+                    delete out;
+                    error = "AsyncWriter: error opening output file : "
+                            + job.file;
+                    break;
+                }
+                sink = sinks_.insert(make_pair(job.file, out)).first;
+            }
+            if (job.kind == Job::WRITE) {
+                sink->second->write(job.data.data(), job.data.size());
+                if (!sink->second->good())
+                    error = "AsyncWriter: error writing file : " + job.file;
+            }
+            break;
+        }
+        case Job::FLUSH:
+            for (map<string, ofstream*>::iterator it = sinks_.begin();
+                 it != sinks_.end(); ++it)
+                it->second->flush();
+            break;
+        case Job::CLOSE: {
+            map<string, ofstream*>::iterator sink = sinks_.find(job.file);
+            if (sink != sinks_.end()) {
+                sink->second->close();
+                delete sink->second;
+                sinks_.erase(sink);
+            }
+            break;
+        }
+        case Job::STOP:
+            break;
+    }
+
+    if (!error.empty()) {
+        pthread_mutex_lock(&mutex_);
+        error_ = error;
+        ++errors_;
+        pthread_mutex_unlock(&mutex_);
+    }
+}
@@ -13,6 +13,7 @@
 #include "DammPlotIds.hpp"
 #include "Globals.hpp"
 #include "Messenger.hpp"
+#include "MtcCycle.hpp"
 #include "RawEvent.hpp"
 
 using namespace dammIds::logic;
@@ -73,19 +74,19 @@ bool BeamLogicProcessor::PreProcess(RawEvent &event)
             }
 
             // If beam was stopped, activate place and plot stop length
-            if (!TreeCorrelator::get()->place("Beam")->status()) {
+            if (!MtcCycle::get()->IsBeamOn()) {
                 double clockInSeconds = Globals::get()->clockInSeconds();
                 double resolution = 1.0 / clockInSeconds;
 
                 plot(D_TIME_STOP_LENGTH, dt_beam_stop / resolution);
 
-                TreeCorrelator::get()->place("Beam")->activate(time);
+                MtcCycle::get()->SetBeam(true, time);
                 ss << "Beam started after: " << dt_beam_stop / resolution
                    << " s ";
 		//                m.run_message(ss.str());
             } 
             else {
-                TreeCorrelator::get()->place("Beam")->deactivate(time);
+                MtcCycle::get()->SetBeam(false, time);
                 ss << "Beam stopped";
 		//     m.run_message(ss.str());
             }
@@ -6,6 +6,7 @@
 #include <sstream>
 
 #include "DammPlotIds.hpp"
+#include "MtcCycle.hpp"
 #include "RawEvent.hpp"
 #include "ChanEvent.hpp"
 #include "BetaScintProcessor.hpp"
@@ -158,10 +159,10 @@ bool Beta4Hen3Processor::Process(RawEvent &event)
     double clockInSeconds = Globals::get()->clockInSeconds();
 
     /** Place Cycle is activated by BeamOn event and deactivated by TapeMove*/
-    bool tapeMove = !(TreeCorrelator::get()->place("Cycle")->status());
+    bool tapeMove = !(MtcCycle::get()->IsInCycle());
 
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = MtcCycle::get()->CycleTime();
 
     for (vector<ChanEvent*>::const_iterator it = scintBetaEvents.begin(); 
 	 it != scintBetaEvents.end(); it++) {
@@ -8,6 +8,7 @@
 #include <sstream>
 
 #include "DammPlotIds.hpp"
+#include "MtcCycle.hpp"
 #include "RawEvent.hpp"
 #include "ChanEvent.hpp"
 #include "BetaScintProcessor.hpp"
@@ -147,10 +148,10 @@ bool BetaScintProcessor::Process(RawEvent &event)
     double clockInSeconds = Globals::get()->clockInSeconds();
 
     /** Place Cycle is activated by BeamOn event and deactivated by TapeMove*/
-    bool tapeMove = !(TreeCorrelator::get()->place("Cycle")->status());
+    bool tapeMove = !(MtcCycle::get()->IsInCycle());
 
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = MtcCycle::get()->CycleTime();
 
     /** True if gammas were recorded during the event */
 
@@ -168,13 +169,13 @@ bool BetaScintProcessor::Process(RawEvent &event)
         /* Beta events gated by "Beta" place are plotted here 
          * Energy-time spectra are gated
          * */
-        for (deque<EventData>::iterator itb = betas->info_.begin();
-             itb != betas->info_.end(); ++itb) {
-            if (itb->energy == energy && itb->time == time &&
-                itb->location == location) {
+        for (unsigned index = 0; index < betas->info_.size(); ++index) {
+            const EventData& beta = betas->info_[index];
+            if (beta.energy == energy && beta.time == time &&
+                beta.location == location) {
                 ++multiplicityThres;
                 plot(D_ENERGY_BETA_THRES_GATED, energyBin);
-                //Break the deque loop since we found the matching event
+                //Break the fifo loop since we found the matching event
                 break;
             }
         }
@@ -1,3 +1,6 @@
+#include <cmath>
+#include <cstring>
+
 #include "ChanEvent.hpp"
 
 /**
@@ -44,6 +47,7 @@ void ChanEvent::ZeroNums()
     highResTime   = -1;
 
     trigTime    = pixie::U_DELIMITER;
+    cfdTime     = pixie::U_DELIMITER;
     eventTimeLo = pixie::U_DELIMITER;
     eventTimeHi = pixie::U_DELIMITER;
     runTime0    = pixie::U_DELIMITER;
@@ -51,9 +55,13 @@ void ChanEvent::ZeroNums()
     runTime2    = pixie::U_DELIMITER;
     chanNum     = -1;
     modNum      = -1;
+    traceExpanded = false;
     for (int i=0; i < numQdcs; i++) {
 	qdcValue[i] = pixie::U_DELIMITER;
     }
+    for (int i=0; i < numEsums; i++) {
+	esumValue[i] = pixie::U_DELIMITER;
+    }
 }
 
 unsigned long ChanEvent::GetQdcValue(int i) const
@@ -64,6 +72,69 @@ unsigned long ChanEvent::GetQdcValue(int i) const
     return qdcValue[i];
 }
 
+unsigned long ChanEvent::GetEsumValue(int i) const
+{
+    if (i < 0 || i >= numEsums) {
+	return pixie::U_DELIMITER;
+    } 
+    return esumValue[i];
+}
+
+/**
+ * The last of the onboard sums is the baseline of the energy filter
+ * stored as IEEE 754 single precision number.
+ */
+double ChanEvent::GetEsumBaseline() const
+{
+    if (!HasEsums())
+        return NAN;
+    float baseline;
+    memcpy(&baseline, &esumValue[3], sizeof(baseline));
+    return baseline;
+}
+
+/**
+ * Recalculate the trapezoidal filter energy from the onboard sums
+ * with the decay correction (see Pixie-16 manual). Tau and rise
+ * time are given in seconds, NAN is returned if not possible.
+ */
+double ChanEvent::GetEsumEnergy(double tau, double rise) const
+{
+    if (!HasEsums() || tau <= 0 || rise <= 0)
+        return NAN;
+
+    double clock = Globals::get()->filterClockInSeconds();
+    double b1 = exp(-clock / tau);
+    double a0 = pow(b1, rise / clock);
+    double c0 = -(1 - b1) * a0 / (1 - a0);
+    double c1 = (1 - b1) / (1 - a0);
+    double cg = 1 - b1;
+
+    return (c0 * esumValue[0] + c1 * esumValue[1] + cg * esumValue[2] -
+            GetEsumBaseline());
+}
+
+/**
+ * Decode the CFD time into the fraction of the adc clock tick.
+ * Revision D (100 MHz): 15 bits of fraction, bit 15 is the forced trigger.
+ * Revision F (250 MHz): 14 bits of fraction, bit 14 is the trigger
+ * source (which of the two adc samples within a filter clock),
+ * bit 15 is the forced trigger.
+ */
+double ChanEvent::GetCfdPhase() const
+{
+    static const bool is250MHz = (Globals::get()->revision() == "F");
+
+    if (cfdTime == pixie::U_DELIMITER || (cfdTime & 0x8000) != 0)
+        return NAN;
+
+    if (is250MHz) {
+        double fraction = (cfdTime & 0x3FFF) / 16384.0;
+        return fraction - ((cfdTime & 0x4000) >> 14);
+    }
+    return (cfdTime & 0x7FFF) / 32768.0;
+}
+
 //* Find the identifier in the map for the channel event */
 const Identifier& ChanEvent::GetChanID() const
 {
@@ -88,6 +159,26 @@ void ChanEvent::ZeroVar()
     ZeroNums();
 
     // clear objects
+    rawTrace.clear();
+    trace.SetPacked(NULL);
     trace.clear();
+    trace.ResetSums();
+}
+
+/**
+ * Expand the packed 16-bit samples into the int trace used by the analyzers.
+ * Values already stored in the trace (e.g. saturation flag) are kept. A trace
+ * filled directly (virtual channels) is left as it is. The packed samples are
+ * released, so that the trace is held only once.
+ */
+void ChanEvent::ExpandTrace() const
+{
+    if (trace.empty()) {
+        trace.assign(rawTrace.begin(), rawTrace.end());
+        trace.ResetSums();
+    }
+    trace.SetPacked(NULL);
+    std::vector<pixie::halfword_t>().swap(rawTrace);
+    traceExpanded = true;
 }
 
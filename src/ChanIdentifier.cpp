@@ -42,6 +42,9 @@ void Identifier::Zero()
     location = -1;
     type     = "";
     subtype  = "";
+    onboard  = false;
+    esumTau  = 0;
+    esumRise = 0;
 
     tag.clear();
 }
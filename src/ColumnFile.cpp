@@ -0,0 +1,272 @@
+/** \file ColumnFile.cpp
+ *
+ * Columnar event output without ROOT
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <zlib.h>
+
+#include "AsyncWriter.hpp"
+#include "ColumnFile.hpp"
+#include "Exceptions.hpp"
+
+using namespace std;
+
+namespace {
+    const char columnMagic[8] = {'P', 'X', 'C', 'O', 'L', 'U', 'M', 'N'};
+    const uint32_t columnVersion = 1;
+
+    unsigned columnWidth(ColumnType type) {
+        return type == column_double ? sizeof(double) : sizeof(int32_t);
+    }
+
+    template<typename T>
+    void put(string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    T readValue(ifstream& in) {
+        T value = T();
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+}
+
+vector<ColumnWriter*> ColumnWriter::open_;
+
+ColumnWriter::ColumnWriter(const string& fileName, unsigned chunkSize) {
+    fileName_ = fileName;
+    chunkSize_ = chunkSize > 0 ? chunkSize : 1;
+    rows_ = 0;
+    entries_ = 0;
+    headerWritten_ = false;
+    closed_ = false;
+
+    /** Create (truncate) the file here to report problems early, the
+     * chunks are appended by the AsyncWriter thread */
+    ofstream out(fileName_.c_str(), ios::binary | ios::trunc);
+    if (!out.good())
+        throw IOException("ColumnWriter: could not open file " + fileName_);
+    out.close();
+
+    /** The processors owning the writers are not destroyed, the files
+     * are closed at exit, before the AsyncWriter shuts down */
+    static bool atExitRegistered = false;
+    AsyncWriter::get();
+    if (!atExitRegistered) {
+        atexit(CloseAtExit);
+        atExitRegistered = true;
+    }
+    open_.push_back(this);
+}
+
+ColumnWriter::~ColumnWriter() {
+    try {
+        Close();
+    } catch (GeneralException &e) {
+        cout << "Exception caught while closing " << fileName_ << endl;
+        cout << "\t" << e.what() << endl;
+    }
+    AsyncWriter::get()->Sync();
+}
+
+void ColumnWriter::Close() {
+    if (closed_)
+        return;
+    closed_ = true;
+    open_.erase(remove(open_.begin(), open_.end(), this), open_.end());
+    Flush();
+    AsyncWriter::get()->Close(fileName_);
+}
+
+void ColumnWriter::FlushAll() {
+    for (vector<ColumnWriter*>::iterator it = open_.begin();
+         it != open_.end(); ++it)
+        (*it)->Flush();
+}
+
+void ColumnWriter::CloseAtExit() {
+    while (!open_.empty()) {
+        ColumnWriter* writer = open_.back();
+        try {
+            writer->Close();
+        } catch (GeneralException &e) {
+            cout << "Exception caught while closing " << writer->fileName_
+                 << endl;
+            cout << "\t" << e.what() << endl;
+        }
+    }
+}
+
+void ColumnWriter::AddColumn(const string& name, const double* value) {
+    AddColumn(name, column_double, value);
+}
+
+void ColumnWriter::AddColumn(const string& name, const int* value) {
+    AddColumn(name, column_int, value);
+}
+
+void ColumnWriter::AddColumn(const string& name, const unsigned* value) {
+    AddColumn(name, column_int, value);
+}
+
+void ColumnWriter::AddColumn(const string& name, ColumnType type,
+                             const void* address) {
+    if (headerWritten_ || entries_ > 0 || rows_ > 0)
+        throw GeneralException("ColumnWriter: column " + name +
+                               " added after the first entry");
+    for (vector<Column>::const_iterator it = columns_.begin();
+         it != columns_.end(); ++it) {
+        if (it->name == name)
+            throw GeneralException("ColumnWriter: column " + name +
+                                   " already exists");
+    }
+    Column column;
+    column.name = name;
+    column.type = type;
+    column.address = address;
+    column.buffer.reserve(chunkSize_ * columnWidth(type));
+    columns_.push_back(column);
+}
+
+void ColumnWriter::WriteHeader() {
+    string header(columnMagic, sizeof(columnMagic));
+    put(header, columnVersion);
+    put(header, (uint32_t)columns_.size());
+    for (vector<Column>::const_iterator it = columns_.begin();
+         it != columns_.end(); ++it) {
+        put(header, (uint32_t)it->name.size());
+        header.append(it->name);
+        put(header, (uint8_t)it->type);
+    }
+    AsyncWriter::get()->Write(fileName_, header);
+    headerWritten_ = true;
+}
+
+void ColumnWriter::Fill() {
+    for (vector<Column>::iterator it = columns_.begin();
+         it != columns_.end(); ++it) {
+        if (it->type == column_double) {
+            const char* bytes = static_cast<const char*>(it->address);
+            it->buffer.insert(it->buffer.end(), bytes,
+                              bytes + sizeof(double));
+        } else {
+            int32_t value = *static_cast<const int*>(it->address);
+            const char* bytes = reinterpret_cast<const char*>(&value);
+            it->buffer.insert(it->buffer.end(), bytes,
+                              bytes + sizeof(int32_t));
+        }
+    }
+    ++rows_;
+    ++entries_;
+    if (rows_ >= chunkSize_)
+        Flush();
+}
+
+void ColumnWriter::Flush() {
+    if (!headerWritten_)
+        WriteHeader();
+    if (rows_ == 0)
+        return;
+
+    string chunk;
+    put(chunk, (uint32_t)rows_);
+    for (vector<Column>::iterator it = columns_.begin();
+         it != columns_.end(); ++it) {
+        uLongf size = compressBound(it->buffer.size());
+        compressed_.resize(size);
+        int status = compress2(&compressed_[0], &size,
+                   reinterpret_cast<const Bytef*>(&it->buffer[0]),
+                   it->buffer.size(), Z_BEST_SPEED);
+        if (status != Z_OK) {
+            stringstream ss;
+            ss << "ColumnWriter: compression of column " << it->name
+               << " failed with status " << status;
+            throw GeneralException(ss.str());
+        }
+        put(chunk, (uint32_t)size);
+        chunk.append(reinterpret_cast<const char*>(&compressed_[0]), size);
+        it->buffer.clear();
+    }
+    rows_ = 0;
+    AsyncWriter::get()->Write(fileName_, chunk);
+}
+
+ColumnReader::ColumnReader(const string& fileName) {
+    fileName_ = fileName;
+    rows_ = 0;
+
+    in_.open(fileName_.c_str(), ios::binary);
+    char magic[sizeof(columnMagic)];
+    in_.read(magic, sizeof(magic));
+    uint32_t version = readValue<uint32_t>(in_);
+    if (!in_ || memcmp(magic, columnMagic, sizeof(magic)) != 0 ||
+        version != columnVersion)
+        throw IOException("ColumnReader: " + fileName_ +
+                          " is not a column file of a known version");
+
+    uint32_t numColumns = readValue<uint32_t>(in_);
+    for (uint32_t i = 0; i < numColumns && in_; ++i) {
+        Column column;
+        uint32_t length = readValue<uint32_t>(in_);
+        column.name.resize(length);
+        if (length > 0)
+            in_.read(&column.name[0], length);
+        column.type = (ColumnType)readValue<uint8_t>(in_);
+        columns_.push_back(column);
+    }
+    if (!in_)
+        throw IOException("ColumnReader: damaged header of " + fileName_);
+}
+
+int ColumnReader::Find(const string& name) const {
+    for (unsigned i = 0; i < columns_.size(); ++i) {
+        if (columns_[i].name == name)
+            return i;
+    }
+    return -1;
+}
+
+bool ColumnReader::NextChunk() {
+    uint32_t rows = readValue<uint32_t>(in_);
+    if (!in_) {
+        rows_ = 0;
+        return false;
+    }
+    for (vector<Column>::iterator it = columns_.begin();
+         it != columns_.end(); ++it) {
+        uint32_t size = readValue<uint32_t>(in_);
+        compressed_.resize(size);
+        if (size > 0)
+            in_.read(reinterpret_cast<char*>(&compressed_[0]), size);
+        uLongf length = rows * columnWidth(it->type);
+        it->values.resize(length);
+        if (!in_ ||
+            uncompress(reinterpret_cast<Bytef*>(&it->values[0]), &length,
+                       &compressed_[0], size) != Z_OK ||
+            length != rows * columnWidth(it->type))
+            throw IOException("ColumnReader: damaged chunk in " + fileName_);
+    }
+    rows_ = rows;
+    return true;
+}
+
+double ColumnReader::Get(unsigned column, unsigned row) const {
+    const Column& c = columns_.at(column);
+    if (row >= rows_)
+        throw GeneralException("ColumnReader: row out of range");
+    if (c.type == column_double) {
+        double value;
+        memcpy(&value, &c.values[row * sizeof(double)], sizeof(double));
+        return value;
+    } else {
+        int32_t value;
+        memcpy(&value, &c.values[row * sizeof(int32_t)], sizeof(int32_t));
+        return value;
+    }
+}
@@ -0,0 +1,65 @@
+/** \file ColumnProcessor.cpp
+ *
+ * Implementation of class to dump event info to a columnar file
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+#include "ColumnFile.hpp"
+#include "ColumnProcessor.hpp"
+#include "DetectorDriver.hpp"
+
+using namespace std;
+
+/** Open a file for columnar output */
+ColumnProcessor::ColumnProcessor(const string &fileName, unsigned chunkSize)
+    : EventProcessor()
+{
+    name = "ColumnProcessor";
+    writer = new ColumnWriter(fileName, chunkSize);
+}
+
+/** Add columns from the event processors in the driver */
+bool ColumnProcessor::Init(RawEvent& rawev)
+{
+    DetectorDriver* driver = DetectorDriver::get();
+
+    const vector<EventProcessor *>& drvProcess = driver->GetProcessors();
+
+    for (vector<EventProcessor *>::const_iterator it = drvProcess.begin();
+        it != drvProcess.end(); it++) {
+        if ((*it)->AddColumns(writer)) {
+            vecProcess.push_back(*it);
+            set_union( (*it)->GetTypes().begin(), (*it)->GetTypes().end(),
+                associatedTypes.begin(), associatedTypes.end(),
+                inserter(associatedTypes, associatedTypes.begin()) );
+        }
+    }
+    return EventProcessor::Init(rawev);
+}
+
+/** Add a row for each event, the writer stores rows in chunks */
+bool ColumnProcessor::Process(RawEvent &event)
+{
+    if (!EventProcessor::Process(event))
+        return false;
+
+    for (vector<EventProcessor *>::iterator it = vecProcess.begin();
+         it != vecProcess.end(); it++) {
+        (*it)->FillColumns();
+    }
+
+    writer->Fill();
+
+    EndProcess();
+    return true;
+}
+
+/** Write the last chunk and close the file */
+ColumnProcessor::~ColumnProcessor()
+{
+    cout << "  saving " << writer->GetEntries() << " column entries" << endl;
+    delete writer;
+}
@@ -0,0 +1,302 @@
+/** \file ConfigSnapshot.cpp
+ *
+ * Binary snapshot of the resolved channel map, calibrations and walk
+ * corrections
+ */
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Configuration.hpp"
+#include "ConfigSnapshot.hpp"
+#include "Messenger.hpp"
+
+using namespace std;
+
+namespace {
+    /** Identifies the file type, followed by version and hash */
+    const char snapshotMagic[8] = {'P', 'X', 'C', 'F', 'S', 'N', 'A', 'P'};
+
+    /** Helpers writing plain values to the snapshot file */
+    template<typename T>
+    void put(ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(ofstream& out, const string& value) {
+        put(out, (uint32_t)value.size());
+        out.write(value.data(), value.size());
+    }
+
+    void putParams(ofstream& out, const vector<SnapshotParams>& records) {
+        put(out, (uint32_t)records.size());
+        for (vector<SnapshotParams>::const_iterator it = records.begin();
+             it != records.end(); ++it) {
+            put(out, (int32_t)it->module);
+            put(out, (int32_t)it->channel);
+            putString(out, it->model);
+            put(out, it->min);
+            put(out, it->max);
+            put(out, (uint32_t)it->parameters.size());
+            for (vector<double>::const_iterator p = it->parameters.begin();
+                 p != it->parameters.end(); ++p)
+                put(out, *p);
+        }
+    }
+
+    /** Reads plain values from the mapped file, any read past the end
+     * sets ok to false and returns zeros */
+    class Reader {
+    public:
+        Reader(const char* data, size_t size) {
+            data_ = data;
+            size_ = size;
+            pos_ = 0;
+            ok = true;
+        }
+
+        template<typename T>
+        T get() {
+            T value = T();
+            if (pos_ + sizeof(T) > size_) {
+                ok = false;
+                return value;
+            }
+            memcpy(&value, data_ + pos_, sizeof(T));
+            pos_ += sizeof(T);
+            return value;
+        }
+
+        string getString() {
+            uint32_t length = get<uint32_t>();
+            if (!ok || pos_ + length > size_) {
+                ok = false;
+                return string();
+            }
+            string value(data_ + pos_, length);
+            pos_ += length;
+            return value;
+        }
+
+        bool getParams(vector<SnapshotParams>& records) {
+            uint32_t number = get<uint32_t>();
+            for (uint32_t i = 0; i < number && ok; ++i) {
+                SnapshotParams record;
+                record.module = get<int32_t>();
+                record.channel = get<int32_t>();
+                record.model = getString();
+                record.min = get<double>();
+                record.max = get<double>();
+                uint32_t numPars = get<uint32_t>();
+                for (uint32_t j = 0; j < numPars && ok; ++j)
+                    record.parameters.push_back(get<double>());
+                records.push_back(record);
+            }
+            return ok;
+        }
+
+        bool atEnd() const {
+            return pos_ == size_;
+        }
+
+        bool ok;
+
+    private:
+        const char* data_;
+        size_t size_;
+        size_t pos_;
+    };
+}
+
+ConfigSnapshot* ConfigSnapshot::instance = NULL;
+const uint32_t ConfigSnapshot::version_;
+
+/** Instance is created upon first call */
+ConfigSnapshot* ConfigSnapshot::get() {
+    if (!instance) {
+        instance = new ConfigSnapshot();
+    }
+    return instance;
+}
+
+ConfigSnapshot::ConfigSnapshot() {
+    string config = Configuration::get()->fileName();
+    file_name_ = config + ".snapshot";
+    hash_ = hashFile(config);
+    loaded_ = load();
+
+    Messenger m;
+    if (loaded_)
+        m.detail("Using configuration snapshot " + file_name_);
+}
+
+uint64_t ConfigSnapshot::hashFile(const string& name) {
+    ifstream in(name.c_str(), ios::binary);
+    if (!in.good())
+        return 0;
+
+    uint64_t hash = 14695981039346656037ULL;
+    char buffer[4096];
+    while (in) {
+        in.read(buffer, sizeof(buffer));
+        streamsize n = in.gcount();
+        for (streamsize i = 0; i < n; ++i) {
+            hash ^= (unsigned char)buffer[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+bool ConfigSnapshot::load() {
+    if (hash_ == 0)
+        return false;
+
+    int fd = open(file_name_.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = info.st_size;
+    void* mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    Reader reader(static_cast<const char*>(mapped), size);
+    char magic[sizeof(snapshotMagic)];
+    for (unsigned i = 0; i < sizeof(magic); ++i)
+        magic[i] = reader.get<char>();
+    bool ok = reader.ok &&
+              memcmp(magic, snapshotMagic, sizeof(magic)) == 0 &&
+              reader.get<uint32_t>() == version_ &&
+              reader.get<uint64_t>() == hash_;
+
+    if (ok) {
+        uint32_t number = reader.get<uint32_t>();
+        for (uint32_t i = 0; i < number && reader.ok; ++i) {
+            SnapshotChannel record;
+            record.module = reader.get<int32_t>();
+            record.channel = reader.get<int32_t>();
+            record.id.SetType(reader.getString());
+            record.id.SetSubtype(reader.getString());
+            record.id.SetLocation(reader.get<int32_t>());
+            record.id.SetOnboard(reader.get<uint8_t>() != 0);
+            record.id.SetEsumTau(reader.get<double>());
+            record.id.SetEsumRise(reader.get<double>());
+            uint32_t numTags = reader.get<uint32_t>();
+            for (uint32_t j = 0; j < numTags && reader.ok; ++j) {
+                string name = reader.getString();
+                record.id.AddTag(name, reader.get<int32_t>());
+            }
+            channels_.push_back(record);
+        }
+        ok = reader.ok && reader.getParams(calibrations_) &&
+             reader.getParams(walks_) && reader.atEnd();
+    }
+    munmap(mapped, size);
+
+    if (!ok) {
+        channels_.clear();
+        calibrations_.clear();
+        walks_.clear();
+    }
+    return ok;
+}
+
+void ConfigSnapshot::addChannel(int module, int channel,
+                                const Identifier& id) {
+    SnapshotChannel record;
+    record.module = module;
+    record.channel = channel;
+    record.id = id;
+    channels_.push_back(record);
+}
+
+void ConfigSnapshot::addCalibration(int module, int channel,
+                                    const string& model,
+                                    double min, double max,
+                                    const vector<double>& parameters) {
+    SnapshotParams record;
+    record.module = module;
+    record.channel = channel;
+    record.model = model;
+    record.min = min;
+    record.max = max;
+    record.parameters = parameters;
+    calibrations_.push_back(record);
+}
+
+void ConfigSnapshot::addWalk(int module, int channel,
+                             const string& model,
+                             double min, double max,
+                             const vector<double>& parameters) {
+    SnapshotParams record;
+    record.module = module;
+    record.channel = channel;
+    record.model = model;
+    record.min = min;
+    record.max = max;
+    record.parameters = parameters;
+    walks_.push_back(record);
+}
+
+void ConfigSnapshot::save() {
+    if (loaded_ || hash_ == 0)
+        return;
+
+    Messenger m;
+    /** Write to a temporary file first, so a job running in parallel
+     * never maps a half written snapshot */
+    string temp_name = file_name_ + ".tmp";
+    ofstream out(temp_name.c_str(), ios::binary | ios::trunc);
+    if (!out.good()) {
+        m.warning("Could not write configuration snapshot " + file_name_);
+        return;
+    }
+
+    out.write(snapshotMagic, sizeof(snapshotMagic));
+    put(out, version_);
+    put(out, hash_);
+
+    put(out, (uint32_t)channels_.size());
+    for (vector<SnapshotChannel>::const_iterator it = channels_.begin();
+         it != channels_.end(); ++it) {
+        put(out, (int32_t)it->module);
+        put(out, (int32_t)it->channel);
+        putString(out, it->id.GetType());
+        putString(out, it->id.GetSubtype());
+        put(out, (int32_t)it->id.GetLocation());
+        put(out, (uint8_t)it->id.UseOnboard());
+        put(out, it->id.GetEsumTau());
+        put(out, it->id.GetEsumRise());
+        const map<string, Identifier::TagValue>& tags = it->id.GetTags();
+        put(out, (uint32_t)tags.size());
+        for (map<string, Identifier::TagValue>::const_iterator tag =
+                tags.begin(); tag != tags.end(); ++tag) {
+            putString(out, tag->first);
+            put(out, (int32_t)tag->second);
+        }
+    }
+    putParams(out, calibrations_);
+    putParams(out, walks_);
+    out.close();
+
+    if (!out.good() || rename(temp_name.c_str(), file_name_.c_str()) != 0) {
+        m.warning("Could not write configuration snapshot " + file_name_);
+        remove(temp_name.c_str());
+        return;
+    }
+    m.detail("Configuration snapshot written to " + file_name_);
+}
@@ -0,0 +1,85 @@
+/** \file Configuration.cpp
+ *
+ * Parsed Config.xml shared by all parts of the program
+ */
+#include <set>
+#include <sstream>
+
+#include "Configuration.hpp"
+#include "Exceptions.hpp"
+#include "Messenger.hpp"
+
+using namespace std;
+
+Configuration* Configuration::instance = NULL;
+
+/** Instance is created upon first call */
+Configuration* Configuration::get() {
+    if (!instance) {
+        instance = new Configuration();
+    }
+    return instance;
+}
+
+Configuration::Configuration() {
+    file_name_ = "Config.xml";
+
+    pugi::xml_parse_result result = doc_.load_file(file_name_.c_str());
+    if (!result) {
+        stringstream ss;
+        ss << "Configuration: error parsing file " << file_name_;
+        ss << " : " << result.description();
+        throw IOException(ss.str());
+    }
+
+    root_ = doc_.child("Configuration");
+    validate();
+}
+
+void Configuration::validate() {
+    if (!root_) {
+        stringstream ss;
+        ss << "Configuration: file " << file_name_
+           << " has no <Configuration> node";
+        throw GeneralException(ss.str());
+    }
+
+    const char* required[] = {"Global", "DetectorDriver", "Map"};
+    const unsigned numRequired = sizeof(required) / sizeof(required[0]);
+    for (unsigned i = 0; i < numRequired; ++i) {
+        if (!root_.child(required[i])) {
+            stringstream ss;
+            ss << "Configuration: missing required section <"
+               << required[i] << "> in " << file_name_;
+            throw GeneralException(ss.str());
+        }
+    }
+
+    set<string> known;
+    known.insert("Author");
+    known.insert("Description");
+    known.insert("Global");
+    known.insert("DetectorDriver");
+    known.insert("Map");
+    known.insert("TreeCorrelator");
+    known.insert("GammaGates");
+    known.insert("Reject");
+    known.insert("Notebook");
+    known.insert("EventTap");
+    known.insert("TimeSlices");
+    known.insert("Skim");
+    known.insert("NoteBook");
+
+    Messenger m;
+    for (pugi::xml_node node = root_.first_child(); node;
+         node = node.next_sibling()) {
+        if (node.type() != pugi::node_element)
+            continue;
+        if (known.find(node.name()) == known.end()) {
+            stringstream ss;
+            ss << "Configuration: unknown section <" << node.name()
+               << "> in " << file_name_;
+            m.warning(ss.str());
+        }
+    }
+}
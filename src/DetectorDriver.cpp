@@ -45,16 +45,27 @@
 
 #include "pugixml.hpp"
 
+#include "ConfigSnapshot.hpp"
+#include "Configuration.hpp"
 #include "DammPlotIds.hpp"
 #include "DetectorDriver.hpp"
 #include "DetectorLibrary.hpp"
+#include "EventCache.hpp"
+#include "EventTap.hpp"
+#include "MtcCycle.hpp"
+#include "PlotsRegister.hpp"
 #include "Exceptions.hpp"
 #include "RandomPool.hpp"
 #include "RawEvent.hpp"
+#include "Skimmer.hpp"
+#include "StatsData.hpp"
+#include "TimeSlices.hpp"
 #include "TimingInformation.hpp"
 #include "TreeCorrelator.hpp"
+#include "WorkerPool.hpp"
 
 #include "BeamLogicProcessor.hpp"
+#include "ColumnProcessor.hpp"
 #include "BetaScintProcessor.hpp"
 #include "Beta4Hen3Processor.hpp"
 #include "DssdProcessor.hpp"
@@ -78,6 +89,7 @@
 #include "TraceFilterer.hpp"
 #include "TriggerLogicProcessor.hpp"
 #include "VandleProcessor.hpp"
+#include "VandleROOT.hpp"
 
 #include "CfdAnalyzer.hpp"
 #include "DoubleTraceAnalyzer.hpp"
@@ -90,8 +102,7 @@
 
 #ifdef useroot
 #include "RootProcessor.hpp"
-#include "ScintRoot.hpp"
-#include "VandleRoot.hpp"
+#include "ScintROOT.hpp"
 #endif
 
 using namespace std;
@@ -161,22 +172,12 @@ DetectorDriver::~DetectorDriver()
 }
 
 void DetectorDriver::LoadProcessors(Messenger& m) {
-    pugi::xml_document doc;
-
-    pugi::xml_parse_result result = doc.load_file("Config.xml");
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file Config.xml";
-        ss << " : " << result.description();
-        throw IOException(ss.str());
-    }
-
     /** Force to create Detector Library before loading processors.
      * It is not needed but the output looks nicer ;)
      */
     DetectorLibrary* modChan = DetectorLibrary::get();
 
-    pugi::xml_node driver = doc.child("Configuration").child("DetectorDriver");
+    pugi::xml_node driver = Configuration::get()->section("DetectorDriver");
     for (pugi::xml_node processor = driver.child("Processor"); processor;
          processor = processor.next_sibling("Processor")) {
         string name = processor.attribute("name").value();
@@ -459,14 +460,18 @@ void DetectorDriver::LoadProcessors(Messenger& m) {
 	  vecProcess.push_back(new TriggerLogicProcessor());
 	} else if (name == "VandleProcessor") {
 	  vecProcess.push_back(new VandleProcessor());
+	} else if (name == "VandleROOT") {
+	  vecProcess.push_back(new VandleROOT());
+	} else if (name == "ColumnProcessor") {
+	  string file = processor.attribute("file").as_string("events.col");
+	  unsigned chunk = processor.attribute("chunk").as_uint(4096);
+	  vecProcess.push_back(new ColumnProcessor(file, chunk));
 	}
 #ifdef useroot
         else if (name == "RootProcessor") {
             vecProcess.push_back(new RootProcessor("tree.root", "tree"));
         } else if (name == "ScintROOT") {
             vecProcess.push_back(new ScintROOT());
-        } else if (name == "VandleROOT") {
-            vecProcess.push_back(new VandleROOT());
         }
 #endif
         else {
@@ -603,6 +608,14 @@ int DetectorDriver::Init(RawEvent& rawev)
 	(*it)->Init();
 	(*it)->SetLevel(20); //! Plot traces
     }
+    MapAnalyzers();
+    MapPlaces();
+    // reads the EventTap section and enables the capture points
+    EventTap::get();
+    // takes the initial cycle state from the Beam, Cycle and TapeMove places
+    MtcCycle::get();
+    // reads the Skim section and copies the DIR and HEAD records
+    Skimmer::get();
 
     // initialize processors in the event processing vector
     for (vector<EventProcessor *>::iterator it = vecProcess.begin();
@@ -613,6 +626,9 @@ int DetectorDriver::Init(RawEvent& rawev)
     try {
         ReadCalXml();
         ReadWalkXml();
+        /** Store resolved map and corrections for the next run,
+         * does nothing if they were loaded from the snapshot */
+        ConfigSnapshot::get()->save();
     } catch (GeneralException &e) {
         // Any exception in reading calibration and walk correction
         // will be intercepted here
@@ -636,6 +652,125 @@ int DetectorDriver::Init(RawEvent& rawev)
     return 0;
 }
 
+/*!
+  Resolve once which trace analyzers accept each channel of the map, so
+  the spill-level trace analysis does not compare type strings per hit.
+*/
+void DetectorDriver::MapAnalyzers()
+{
+    DetectorLibrary* modChan = DetectorLibrary::get();
+
+    chanAnalyzers.assign(modChan->size(), vector<unsigned>());
+    chanExpand.assign(modChan->size(), false);
+    traceBatches.assign(vecAnalyzer.size(), vector<ChanEvent*>());
+
+    for (DetectorLibrary::size_type i = 0; i < modChan->size(); ++i) {
+        if (!modChan->HasValue(i))
+            continue;
+        const Identifier &id = modChan->at(i);
+        if (id.GetType() == "ignore" || id.GetType() == "" || id.UseOnboard())
+            continue;
+        for (unsigned k = 0; k < vecAnalyzer.size(); ++k) {
+            if (!vecAnalyzer[k]->Accepts(id.GetType(), id.GetSubtype()))
+                continue;
+            chanAnalyzers[i].push_back(k);
+            if (!vecAnalyzer[k]->ReadsPacked())
+                chanExpand[i] = true;
+        }
+    }
+}
+
+/*!
+  Resolve the TreeCorrelator place of each channel of the map, so
+  ProcessEvent() does not build and look up the place name per hit.
+*/
+void DetectorDriver::MapPlaces()
+{
+    DetectorLibrary* modChan = DetectorLibrary::get();
+    TreeCorrelator* tree = TreeCorrelator::get();
+
+    chanPlaces.assign(modChan->size(), -1);
+    for (DetectorLibrary::size_type i = 0; i < modChan->size(); ++i) {
+        if (!modChan->HasValue(i))
+            continue;
+        string place = modChan->at(i).GetPlaceName();
+        if (place == "__-1")
+            continue;
+        chanPlaces[i] = tree->handle(place);
+    }
+}
+
+/*!
+  Task of the WorkerPool: gets the samples of the traced hits ready for
+  the analyzers, the hits of [begin, end) are only touched by one thread.
+  The int trace is expanded for the channels needing it, the others read
+  the packed samples, and the running sums are built.
+*/
+void DetectorDriver::PrepareTraces(void* driver, size_t begin, size_t end)
+{
+    DetectorDriver* dd = static_cast<DetectorDriver*>(driver);
+    for (size_t i = begin; i < end; ++i) {
+        ChanEvent* chan = dd->tracedHits[i];
+        Trace &trace = dd->chanExpand[chan->GetID()] ?
+                       chan->GetTrace() : chan->GetSampleTrace();
+        trace.SetHit(chan->GetID(), (uint64_t)chan->GetTime());
+        trace.PrepareSums();
+    }
+}
+
+/*!
+  \brief analyze all traces of a spill
+
+  Called from PixieStd.cpp with the time sorted list of a spill before
+  the events are built. The samples of all the traced hits are first
+  prepared in parallel by the WorkerPool (PrepareTraces). Traced hits are
+  then grouped by analyzer and each analyzer runs over its whole batch in
+  the calling thread, since the analyzers plot and keep their own state.
+  The results are stored in the traces and picked up later by
+  ThreshAndCal(). The analyzers are still applied to a given trace in the
+  order of the configuration file. Analyzers which read the packed samples
+  (ReadsPacked) work on them directly, the trace is expanded to int only
+  for the channels with other analyzers.
+*/
+void DetectorDriver::AnalyzeTraces(const vector<ChanEvent*> &eventList)
+{
+    if (vecAnalyzer.empty())
+        return;
+
+    for (vector<ChanEvent*>::const_iterator it = eventList.begin();
+         it != eventList.end(); ++it) {
+        if (!(*it)->HasTrace())
+            continue;
+        unsigned int id = (*it)->GetID();
+        if (id >= chanAnalyzers.size())
+            continue;
+        const vector<unsigned> &analyzers = chanAnalyzers[id];
+        if (analyzers.empty())
+            continue;
+        tracedHits.push_back(*it);
+        for (vector<unsigned>::const_iterator ia = analyzers.begin();
+             ia != analyzers.end(); ++ia)
+            traceBatches[*ia].push_back(*it);
+    }
+
+    WorkerPool::get()->Run(&DetectorDriver::PrepareTraces, this,
+                           tracedHits.size());
+    tracedHits.clear();
+
+    for (unsigned k = 0; k < vecAnalyzer.size(); ++k) {
+        vector<ChanEvent*> &batch = traceBatches[k];
+        for (vector<ChanEvent*>::iterator it = batch.begin();
+             it != batch.end(); ++it) {
+            const Identifier &chanId = (*it)->GetChanID();
+            Trace &trace = vecAnalyzer[k]->ReadsPacked() ?
+                           (*it)->GetSampleTrace() : (*it)->GetTrace();
+            vecAnalyzer[k]->Analyze(trace,
+                                    chanId.GetType(), chanId.GetSubtype());
+        }
+        batch.clear();
+    }
+}
+
 /*!
   \brief controls event processing
 
@@ -649,25 +784,34 @@ int DetectorDriver::Init(RawEvent& rawev)
   Currently, both RMS and MTC processing is available.  After all processing
   has occured, appropriate plotting routines are called.
 */
-int DetectorDriver::ProcessEvent(RawEvent& rawev){   
+int DetectorDriver::ProcessEvent(RawEvent& rawev, bool calibrated){   
     /*
       Begin the event processing looping over all the channels
       that fired in this particular event.
     */
+    if (TimeSlices::enabled() && rawev.Size() > 0)
+        TimeSlices::get()->Advance(rawev.GetEventList().front()->GetTime());
     plot(dammIds::raw::D_NUMBER_OF_EVENTS, dammIds::GENERIC_CHANNEL);
     
     try {
         for (vector<ChanEvent*>::const_iterator it = rawev.GetEventList().begin();
             it != rawev.GetEventList().end(); ++it) {
-            string place = (*it)->GetChanID().GetPlaceName();
+            unsigned int id = (*it)->GetID();
+            int place = -1;
+            if (id < chanPlaces.size())
+                place = chanPlaces[id];
 
             // skip empty channel
-            if (place == "__-1")
+            if (place < 0)
                 continue;
 
-            // check threshold and calibrate
+            // check threshold and calibrate, channels replayed from
+            // the event cache are calibrated already
             PlotRaw((*it));
-            ThreshAndCal((*it), rawev);
+            if (calibrated)
+                FillSummaries((*it), rawev);
+            else
+                ThreshAndCal((*it), rawev);
             PlotCal((*it));
 
             // Do not activate places if saturated or pileup
@@ -677,21 +821,14 @@ int DetectorDriver::ProcessEvent(RawEvent& rawev){
             double time = (*it)->GetTime();
             double energy = (*it)->GetCalEnergy();
             int location = (*it)->GetChanID().GetLocation();
-	    
-  	    
-          	DetectorDriver* driver = DetectorDriver::get();
-        	time_t theTime;
-     	    theTime = driver -> GetWallTime(time);
-            if (abs(theTime-1412393220)<=100 )  {
-	             stringstream ss;
-                 ss << theTime << " " << time << " " << location <<  " " << energy << endl;
-                  Messenger m;
-                  m.run_message(ss.str());
-        Notebook::get()->report(ss.str());
-	}
             EventData data(time, energy, location);
-            TreeCorrelator::get()->place(place)->activate(data);
+            TreeCorrelator::get()->place((unsigned)place)->activate(data);
         } 
+
+        if (!calibrated && EventCache::get()->writing())
+            EventCache::get()->Write(rawev.GetEventList());
+        if (EventTap::enabled())
+            EventTap::get()->Built(rawev.GetEventList());
     
         // have each processor in the event processing vector handle the event
         /* First round is preprocessing, where process result must be guaranteed
@@ -746,6 +883,10 @@ void DetectorDriver::DeclarePlots()
         DeclareHistogram2D(DD_RUNTIME_MSEC, SE, S7, "run time - ms");
         DeclareHistogram1D(D_NUMBER_OF_EVENTS, S4, "event counter");
         DeclareHistogram1D(D_HAS_TRACE, S8, "channels with traces");
+        DeclareHistogram2D(DD_DEAD_FRACTION, S8, SA,
+                           "dead time per stats block - 0.1%");
+        DeclareHistogram2D(DD_INPUT_RATE, S8, SA,
+                           "input rate per stats block - kHz");
 	
         DetectorLibrary::size_type maxChan = modChan->size();
 
@@ -818,10 +959,9 @@ int DetectorDriver::ThreshAndCal(ChanEvent *chan, RawEvent& rawev)
     int id            = chan->GetID();
     string type       = chanId.GetType();
     string subtype    = chanId.GetSubtype();
-    bool hasStartTag  = chanId.HasTag("start");
-    Trace &trace      = chan->GetTrace();
 
-    RandomPool* randoms = RandomPool::get();
+    // hit time stamp, keys the dithering random numbers
+    uint64_t stamp = (uint64_t)chan->GetTime();
 
     double energy = 0.0;
 
@@ -831,14 +971,12 @@ int DetectorDriver::ThreshAndCal(ChanEvent *chan, RawEvent& rawev)
     /*
       If the channel has a trace get it, analyze it and set the energy.
     */
-    if ( !trace.empty() ) {
+    if ( chan->HasTrace() && !chanId.UseOnboard() ) {
+        // traces were already analyzed for the whole spill in AnalyzeTraces(),
+        // only their values are read here, the samples need not be expanded
+        Trace &trace = chan->GetSampleTrace();
         plot(D_HAS_TRACE, id);
 
-        for (vector<TraceAnalyzer *>::iterator it = vecAnalyzer.begin();
-            it != vecAnalyzer.end(); it++) {	
-                (*it)->Analyze(trace, type, subtype);
-        }
-
         if (trace.HasValue("filterEnergy") ) {     
             if (trace.GetValue("filterEnergy") > 0) {
                 energy = trace.GetValue("filterEnergy");
@@ -879,7 +1017,8 @@ int DetectorDriver::ThreshAndCal(ChanEvent *chan, RawEvent& rawev)
             energy = trace.GetValue("calcEnergy");
             chan->SetEnergy(energy);
         } else if (!trace.HasValue("filterEnergy")) {
-            energy = chan->GetEnergy() + randoms->Get();
+            energy = chan->GetEnergy() +
+                     RandomPool::Get(RandomPool::CALIBRATION, id, stamp);
             energy /= ChanEvent::pixieEnergyContraction;
         }
 
@@ -895,12 +1034,33 @@ int DetectorDriver::ThreshAndCal(ChanEvent *chan, RawEvent& rawev)
         // add a random number to convert an integer value to a 
         //   uniformly distributed floating point
 
-        energy = chan->GetEnergy() + randoms->Get();
+        energy = chan->GetEnergy() +
+                 RandomPool::Get(RandomPool::CALIBRATION, id, stamp);
 	//cout << "raw --------------------------" << endl
 	// << energy << endl;
         energy /= ChanEvent::pixieEnergyContraction; // energy is 4 times smaller now; by YX
 	//cout << energy << endl
 	//   << "--------------------------" << endl;
+
+        if (chanId.UseOnboard()) {
+            // trace-free mode, energy from the onboard sums if the filter
+            // parameters are known and sub-sample time from the onboard CFD
+            double esumEnergy = chan->GetEsumEnergy(chanId.GetEsumTau(),
+                                                    chanId.GetEsumRise());
+            if (!isnan(esumEnergy)) {
+                energy = esumEnergy +
+                    RandomPool::Get(RandomPool::CALIBRATION, id, stamp, 1);
+                energy /= ChanEvent::pixieEnergyContraction;
+            }
+
+            double phase = chan->GetCfdPhase();
+            if (!isnan(phase)) {
+                chan->SetHighResTime(phase *
+                                     Globals::get()->adcClockInSeconds() + 
+                                     chan->GetTrigTime() *
+                                     Globals::get()->filterClockInSeconds());
+            }
+        }
     }
 
     /** Calibrate energy and apply the walk correction. */
@@ -910,9 +1070,23 @@ int DetectorDriver::ThreshAndCal(ChanEvent *chan, RawEvent& rawev)
     chan->SetCalEnergy(cali.GetCalEnergy(chanId, energy));
     chan->SetCorrectedTime(time - walk_correction);
 
-    /*
-      update the detector summary
-    */    
+    FillSummaries(chan, rawev);
+    return 1;
+}
+
+/*!
+  Add the channel to the detector summaries of its type, subtype and
+  start tag
+*/
+void DetectorDriver::FillSummaries(ChanEvent *chan, RawEvent& rawev)
+{
+    const Identifier &chanId = chan->GetChanID();
+    const string &type = chanId.GetType();
+    const string &subtype = chanId.GetSubtype();
+
+    if (type == "ignore" || type == "")
+        return;
+
     rawev.GetSummary(type)->AddEvent(chan);
     DetectorSummary *summary;
     
@@ -920,20 +1094,34 @@ int DetectorDriver::ThreshAndCal(ChanEvent *chan, RawEvent& rawev)
     if (summary != NULL)
         summary->AddEvent(chan);
 
-    if(hasStartTag) {
+    if(chanId.HasTag("start")) {
         summary = 
             rawev.GetSummary(type + ':' + subtype + ':' + "start", false);
         if (summary != NULL)
             summary->AddEvent(chan);
     }
-    
-    return 1;
 }
 
 /*!
   Plot the raw energies of each channel into the damm spectrum number assigned
   to it in the map file with an offset as defined in DammPlotIds.hpp
 */
+/*!
+  Plot the dead time fraction and the input rate of the last interval of
+  the statistics of each channel of the module against the channel id
+*/
+void DetectorDriver::PlotStats(unsigned mod)
+{
+    DetectorLibrary* modChan = DetectorLibrary::get();
+    for (unsigned ch = 0; ch < NUMBER_OF_CHANNELS; ++ch) {
+        unsigned id = mod * NUMBER_OF_CHANNELS + ch;
+        if (!modChan->HasValue(id) || !stats.HasInterval(id))
+            continue;
+        plot(DD_DEAD_FRACTION, id, stats.GetDeadFraction(id) * 1000);
+        plot(DD_INPUT_RATE, id, stats.GetInputRate(id) / 1000);
+    }
+}
+
 int DetectorDriver::PlotRaw(const ChanEvent *chan)
 {
     int id = chan->GetID();
@@ -1011,20 +1199,10 @@ EventProcessor* DetectorDriver::GetProcessor(const std::string &name) const {
 }
 
 void DetectorDriver::ReadCalXml() {
-    pugi::xml_document doc;
-
-    pugi::xml_parse_result result = doc.load_file("Config.xml");
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file Config.xml";
-        ss << " : " << result.description();
-        throw GeneralException(ss.str());
-    }
-
     Messenger m;
     m.start("Loading Calibration");
 
-    pugi::xml_node map = doc.child("Configuration").child("Map");
+    pugi::xml_node map = Configuration::get()->section("Map");
 
     /* Note that before this reading in of the xml file, it was already
      * processed for the purpose of creating the channels map.
@@ -1032,6 +1210,32 @@ void DetectorDriver::ReadCalXml() {
      * so they are not repeated here/
      */
     bool verbose = map.attribute("verbose_calibration").as_bool();
+
+    ConfigSnapshot* snapshot = ConfigSnapshot::get();
+    if (snapshot->loaded()) {
+        const vector<SnapshotParams>& records = snapshot->calibrations();
+        for (vector<SnapshotParams>::const_iterator it = records.begin();
+             it != records.end(); ++it) {
+            Identifier chanID = DetectorLibrary::get()->at(it->module,
+                                                           it->channel);
+            if (verbose) {
+                stringstream ss;
+                ss << "Module " << it->module << ", channel "
+                   << it->channel << ": ";
+                ss << " model-" << it->model;
+                for (vector<double>::const_iterator p =
+                        it->parameters.begin();
+                     p != it->parameters.end(); ++p)
+                    ss << " " << (*p);
+                m.detail(ss.str(), 1);
+            }
+            cali.AddChannel(chanID, it->model, it->min, it->max,
+                            it->parameters);
+        }
+        m.done();
+        return;
+    }
+
     for (pugi::xml_node module = map.child("Module"); module;
          module = module.next_sibling("Module")) {
         int module_number = module.attribute("number").as_int(-1);
@@ -1069,6 +1273,8 @@ void DetectorDriver::ReadCalXml() {
                     m.detail(ss.str(), 1);
                 }
                 cali.AddChannel(chanID, model, min, max, parameters);
+                snapshot->addCalibration(module_number, ch_number, model,
+                                         min, max, parameters);
                 calibrated = true;
             }
             if (!calibrated && verbose) {
@@ -1084,22 +1290,38 @@ void DetectorDriver::ReadCalXml() {
 }
 
 void DetectorDriver::ReadWalkXml() {
-    pugi::xml_document doc;
-
-    pugi::xml_parse_result result = doc.load_file("Config.xml");
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file Config.xml";
-        ss << " : " << result.description();
-        throw GeneralException(ss.str());
-    }
-
     Messenger m;
     m.start("Loading Walk Corrections");
 
-    pugi::xml_node map = doc.child("Configuration").child("Map");
+    pugi::xml_node map = Configuration::get()->section("Map");
     /** See comment in the similiar place at ReadCalXml() */
     bool verbose = map.attribute("verbose_walk").as_bool();
+
+    ConfigSnapshot* snapshot = ConfigSnapshot::get();
+    if (snapshot->loaded()) {
+        const vector<SnapshotParams>& records = snapshot->walks();
+        for (vector<SnapshotParams>::const_iterator it = records.begin();
+             it != records.end(); ++it) {
+            Identifier chanID = DetectorLibrary::get()->at(it->module,
+                                                           it->channel);
+            if (verbose) {
+                stringstream ss;
+                ss << "Module " << it->module
+                   << ", channel " << it->channel << ": ";
+                ss << " model: " << it->model;
+                for (vector<double>::const_iterator p =
+                        it->parameters.begin();
+                     p != it->parameters.end(); ++p)
+                    ss << " " << (*p);
+                m.detail(ss.str(), 1);
+            }
+            walk.AddChannel(chanID, it->model, it->min, it->max,
+                            it->parameters);
+        }
+        m.done();
+        return;
+    }
+
     for (pugi::xml_node module = map.child("Module"); module;
          module = module.next_sibling("Module")) {
         int module_number = module.attribute("number").as_int(-1);
@@ -1138,6 +1360,8 @@ void DetectorDriver::ReadWalkXml() {
                     m.detail(ss.str(), 1);
                 }
                 walk.AddChannel(chanID, model, min, max, parameters);
+                snapshot->addWalk(module_number, ch_number, model,
+                                  min, max, parameters);
                 corrected = true;
             }
             if (!corrected && verbose) {
@@ -1156,4 +1380,6 @@ void DetectorDriver::ReadWalkXml() {
 extern "C" void detectorend_()
 {
   //cout << "ending, no rootfile " << endl;       
+    // write pending symmetric plots before the histograms are saved
+    PlotsRegister::get()->Flush();
 }
@@ -11,6 +11,8 @@
 
 #include "pugixml.hpp"
 
+#include "Configuration.hpp"
+#include "ConfigSnapshot.hpp"
 #include "DetectorLibrary.hpp"
 #include "Globals.hpp"
 #include "Messenger.hpp"
@@ -47,16 +49,6 @@ DetectorLibrary::DetectorLibrary() : vector<Identifier>(), locations(), numModul
 }
 
 void DetectorLibrary::LoadXml() {
-    pugi::xml_document doc;
-
-    pugi::xml_parse_result result = doc.load_file("Config.xml");
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file Config.xml";
-        ss << " : " << result.description();
-        cout << ss.str() << endl;
-    }
-
     Messenger m;
     m.start("Loading channels map");
 
@@ -67,11 +59,27 @@ void DetectorLibrary::LoadXml() {
     reserved.insert("type");
     reserved.insert("subtype");
     reserved.insert("location");
+    reserved.insert("onboard");
+    reserved.insert("esum_tau");
+    reserved.insert("esum_rise");
 
-    pugi::xml_node map = doc.child("Configuration").child("Map");
+    pugi::xml_node map = Configuration::get()->section("Map");
     bool verbose = map.attribute("verbose_map").as_bool();
-    pugi::xml_node tree = doc.child("Configuration").child("TreeCorrelator");
+    pugi::xml_node tree = Configuration::get()->section("TreeCorrelator");
     bool verbose_tree = tree.attribute("verbose").as_bool(false);
+
+    /** Channels resolved in the previous run with the same Config.xml */
+    ConfigSnapshot* snapshot = ConfigSnapshot::get();
+    if (snapshot->loaded()) {
+        const vector<SnapshotChannel>& channels = snapshot->channels();
+        for (vector<SnapshotChannel>::const_iterator it = channels.begin();
+             it != channels.end(); ++it)
+            AddChannel(it->module, it->channel, it->id,
+                       verbose, verbose_tree);
+        m.done();
+        return;
+    }
+
     for (pugi::xml_node module = map.child("Module"); module;
          module = module.next_sibling("Module")) {
         int module_number = module.attribute("number").as_int(-1);
@@ -112,6 +120,12 @@ void DetectorLibrary::LoadXml() {
             }
             id.SetLocation(ch_location);
 
+            /** Trace-free mode: time from the onboard CFD, energy from the
+             * onboard sums (if tau and rise time are given) */
+            id.SetOnboard(channel.attribute("onboard").as_bool(false));
+            id.SetEsumTau(channel.attribute("esum_tau").as_double(0));
+            id.SetEsumRise(channel.attribute("esum_rise").as_double(0));
+
             for (pugi::xml_attribute_iterator ait = channel.attributes_begin();
                  ait != channel.attributes_end(); ++ait) {
                 string name = ait->name();
@@ -121,33 +135,39 @@ void DetectorLibrary::LoadXml() {
                 }
             }
 
-            Set(module_number, ch_number, id);
-
-            /** Create basic place for TreeCorrelator */
-            std::map <string, string> params;
-            params["name"] = id.GetPlaceName();
-            params["parent"] = "root";
-            params["type"] = "PlaceDetector";
-            params["reset"] = "true";
-            params["fifo"] = "2";
-            params["init"] = "false";
-            TreeCorrelator::get()->createPlace(params, verbose_tree);
-
-            if (verbose) {
-                stringstream ss;
-                ss << "Module " << module_number 
-                   << ", channel " << ch_number  << ", type "
-                   << ch_type << " "
-                   << ch_subtype << ", location " 
-                   << ch_location;
-                Messenger m;
-                m.detail(ss.str(), 1);
-            }
+            AddChannel(module_number, ch_number, id, verbose, verbose_tree);
+            snapshot->addChannel(module_number, ch_number, id);
         }
     }
     m.done();
 }
 
+void DetectorLibrary::AddChannel(int module, int ch, const Identifier& id,
+                                 bool verbose, bool verbose_tree) {
+    Set(module, ch, id);
+
+    /** Create basic place for TreeCorrelator */
+    std::map <string, string> params;
+    params["name"] = id.GetPlaceName();
+    params["parent"] = "root";
+    params["type"] = "PlaceDetector";
+    params["reset"] = "true";
+    params["fifo"] = "2";
+    params["init"] = "false";
+    TreeCorrelator::get()->createPlace(params, verbose_tree);
+
+    if (verbose) {
+        stringstream ss;
+        ss << "Module " << module
+           << ", channel " << ch  << ", type "
+           << id.GetType() << " "
+           << id.GetSubtype() << ", location "
+           << id.GetLocation();
+        Messenger m;
+        m.detail(ss.str(), 1);
+    }
+}
+
 DetectorLibrary::~DetectorLibrary()
 {
     // do nothing
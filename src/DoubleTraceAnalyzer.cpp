@@ -90,9 +90,6 @@ void DoubleTraceAnalyzer::DeclarePlots()
 void DoubleTraceAnalyzer::Analyze(Trace &trace, 
 				  const string &type, const string &subtype)
 {    
-    if (subtype == "top" || subtype == "bottom")
-        return;
-
     Messenger m;
 
     TraceFilterer::Analyze(trace, type, subtype);
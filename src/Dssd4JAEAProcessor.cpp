@@ -29,6 +29,7 @@
 #include "TraceFilterer.hpp"
 #include "WaveformAnalyzer.hpp"
 #include "DetectorDriver.hpp"
+#include "EventTap.hpp"
 #include "Notebook.hpp"
 #include "YXEvent.hpp" // by Yongchi Xiao 10/06/2015
 
@@ -64,6 +65,7 @@ Dssd4JAEAProcessor::Dssd4JAEAProcessor(double timeWindow,
 	// add associated type = pin
 	associatedTypes.insert("pin"); 
     numDoubleTraces=0;
+    betaDecayProbe_ = EventTap::get()->Probe("beta-decay-proton");
     
     stringstream ss;
     ss << fixed 
@@ -144,157 +146,32 @@ void Dssd4JAEAProcessor::DeclarePlots(void)
 
 
 
-	// 750-759   
-	/*
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 0, decayEnergyBins, timeBins,
-					   "DSSD Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 1, decayEnergyBins, timeBins, 
-					   "DSSD Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 2, decayEnergyBins, timeBins,
-					   "DSSD Ty,Ex (400ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 3, decayEnergyBins, timeBins,
-					   "DSSD Ty,Ex (1us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 4, decayEnergyBins, timeBins, 
-					   "DSSD Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 5, decayEnergyBins, timeBins,
-					   "DSSD Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 6, decayEnergyBins, timeBins,
-					   "DSSD Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 7, decayEnergyBins, timeBins,
-					   "DSSD Ty,Ex (100ms/ch)(xkeV)");//ntb
-	*/
-
-    /*    
-    // 850-859 GRANX with VETO                                                        
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_VETO + 0, decayEnergyBins, timeBins,
-	"DSSD_VETO Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_VETO + 1, decayEnergyBins, timeBins
-	,                         "DSSD_VETO Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_VETO + 2, decayEnergyBins, timeBins
-	,
-	"DSSD_VETO Ty,Ex (400ns/ch)(xkeV)");
-	*/
-	/*
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_VETO + 3, decayEnergyBins, timeBins
-	,
-	"DSSD_VETO Ty,Ex (1us/ch)(xkeV)");*/
-	/*
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_VETO + 4, decayEnergyBins, timeBins
-	,
-	"DSSD_VETO Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_VETO + 5, decayEnergyBins, timeBins
-	,
-	"DSSD_VETO Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_VETO + 6, decayEnergyBins, timeBins
-	,
-	"DSSD_VETO Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_VETO + 7, decayEnergyBins, timeBins
-	,
-	"DSSD_VETO Ty,Ex (100ms/ch)(xkeV)");
-	*/
-
-    // 860-861 GRANX with VETO                                                        
-	/*
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOVETO + 0, decayEnergyBins, timeBins,
-	"DSSD_NOVETO Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOVETO + 1, decayEnergyBins, timeBins,
-	"DSSD_NOVETO Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOVETO + 2, decayEnergyBins, timeBins,
-	"DSSD_NOVETO Ty,Ex (400ns/ch)(xkeV)");
-	*/
-	/*
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOVETO + 3, decayEnergyBins, timeBins,
-	"DSSD_NOVETO Ty,Ex (1us/ch)(xkeV)");
-	*/
-	/*
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOVETO + 4, decayEnergyBins, timeBins,
-	"DSSD_NOVETO Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOVETO + 5, decayEnergyBins, timeBins,
-	"DSSD_NOVETO Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOVETO + 6, decayEnergyBins, timeBins,
-	"DSSD_NOVETO Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOVETO + 7, decayEnergyBins, timeBins,
-	"DSSD_NOVETO Ty,Ex (100ms/ch)(xkeV)");
-	*/
-    
-    // 860-861 GRANX with NAI
-	/*
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NAI + 0, decayEnergyBins, timeBins,
-	"DSSD_NAI Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NAI + 1, decayEnergyBins, timeBins,
-	"DSSD_NAI Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NAI + 2, decayEnergyBins, timeBins,
-	"DSSD_NAI Ty,Ex (400ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NAI + 3, decayEnergyBins, timeBins,
-	"DSSD_NAI Ty,Ex (1us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NAI + 4, decayEnergyBins, timeBins,
-	"DSSD_NAI Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NAI + 5, decayEnergyBins, timeBins,
-	"DSSD_NAI Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NAI + 6, decayEnergyBins, timeBins,
-	"DSSD_NAI Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NAI + 7, decayEnergyBins, timeBins,
-	"DSSD_NAI Ty,Ex (100ms/ch)(xkeV)");
-	*/
-
-    // 860-861 GRANX with no_NAI
-	/*
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NONAI + 0, decayEnergyBins, timeBins,
-	"DSSD_NONAI Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NONAI + 1, decayEnergyBins, timeBins,
-	"DSSD_NONAI Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NONAI + 2, decayEnergyBins, timeBins,
-	"DSSD_NONAI Ty,Ex (400ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NONAI + 3, decayEnergyBins, timeBins,
-	"DSSD_NONAI Ty,Ex (1us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NONAI + 4, decayEnergyBins, timeBins,
-	"DSSD_NONAI Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NONAI + 5, decayEnergyBins, timeBins,
-	"DSSD_NONAI Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NONAI + 6, decayEnergyBins, timeBins,
-	"DSSD_NONAI Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NONAI + 7, decayEnergyBins, timeBins,
-	"DSSD_NONAI Ty,Ex (100ms/ch)(xkeV)");
-
-
-    // 860-861 GRANX with PIN
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_PIN + 0, decayEnergyBins, timeBins,
-	"DSSD_PIN Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_PIN + 1, decayEnergyBins, timeBins,
-	"DSSD_PIN Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_PIN + 2, decayEnergyBins, timeBins,
-
-
-	"DSSD_PIN Ty,Ex (400ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_PIN + 3, decayEnergyBins, timeBins,
-	"DSSD_PIN Ty,Ex (1us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_PIN + 4, decayEnergyBins, timeBins,
-	"DSSD_PIN Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_PIN + 5, decayEnergyBins, timeBins,
-	"DSSD_PIN Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_PIN + 6, decayEnergyBins, timeBins,
-	"DSSD_PIN Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_PIN + 7, decayEnergyBins, timeBins,
-	"DSSD_PIN Ty,Ex (100ms/ch)(xkeV)");
-
-    // 860-861 GRANX with noPIN
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOPIN + 0, decayEnergyBins, timeBins,
-	"DSSD_NOPIN Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOPIN + 1, decayEnergyBins, timeBins,
-	"DSSD_NOPIN Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOPIN + 2, decayEnergyBins, timeBins,
-	"DSSD_NOPIN Ty,Ex (400ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOPIN + 3, decayEnergyBins, timeBins,
-	"DSSD_NOPIN Ty,Ex (1us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOPIN + 4, decayEnergyBins, timeBins,
-	"DSSD_NOPIN Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOPIN + 5, decayEnergyBins, timeBins,
-	"DSSD_NOPIN Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOPIN + 6, decayEnergyBins, timeBins,
-	"DSSD_NOPIN Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_NOPIN + 7, decayEnergyBins, timeBins,
-	"DSSD_NOPIN Ty,Ex (100ms/ch)(xkeV)");
-
+	/* 750-757, 850-857, 860-867, 870-877, 880-887, 890-897, 900-907
+	 * Decay energy vs. decay time, one histogram per time resolution,
+	 * filled by JAEACorrelator::flush_chain
+	std::vector<float> decayTimeResolution;
+	decayTimeResolution.push_back(10e-9);
+	decayTimeResolution.push_back(100e-9);
+	decayTimeResolution.push_back(400e-9);
+	decayTimeResolution.push_back(1e-6);
+	decayTimeResolution.push_back(100e-6);
+	decayTimeResolution.push_back(1e-3);
+	decayTimeResolution.push_back(10e-3);
+	decayTimeResolution.push_back(100e-3);
+	histo.DeclareGranularY(DD_ENERGY_DECAY_TIME_GRANX, decayEnergyBins,
+	    timeBins, "DSSD Ty,Ex (xkeV)", 1, decayTimeResolution, "s");
+	histo.DeclareGranularY(DD_ENERGY_DECAY_TIME_GRANX_VETO, decayEnergyBins,
+	    timeBins, "DSSD_VETO Ty,Ex (xkeV)", 1, decayTimeResolution, "s");
+	histo.DeclareGranularY(DD_ENERGY_DECAY_TIME_GRANX_NOVETO, decayEnergyBins,
+	    timeBins, "DSSD_NOVETO Ty,Ex (xkeV)", 1, decayTimeResolution, "s");
+	histo.DeclareGranularY(DD_ENERGY_DECAY_TIME_GRANX_NAI, decayEnergyBins,
+	    timeBins, "DSSD_NAI Ty,Ex (xkeV)", 1, decayTimeResolution, "s");
+	histo.DeclareGranularY(DD_ENERGY_DECAY_TIME_GRANX_NONAI, decayEnergyBins,
+	    timeBins, "DSSD_NONAI Ty,Ex (xkeV)", 1, decayTimeResolution, "s");
+	histo.DeclareGranularY(DD_ENERGY_DECAY_TIME_GRANX_PIN, decayEnergyBins,
+	    timeBins, "DSSD_PIN Ty,Ex (xkeV)", 1, decayTimeResolution, "s");
+	histo.DeclareGranularY(DD_ENERGY_DECAY_TIME_GRANX_NOPIN, decayEnergyBins,
+	    timeBins, "DSSD_NOPIN Ty,Ex (xkeV)", 1, decayTimeResolution, "s");
 	*/
     
 
@@ -363,25 +240,9 @@ void Dssd4JAEAProcessor::DeclarePlots(void)
 
     
 	/*
-    // 780 
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 0, decayEnergyBins, timeBins,
-	"2nd  DSSD Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 1, decayEnergyBins, timeBins, 
-	"2nd DSSD Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 2, decayEnergyBins, timeBins,
-	"2nd DSSD Ty,Ex (400ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 3, decayEnergyBins, timeBins,
-	"2nd DSSD Ty,Ex (1us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 4, decayEnergyBins, timeBins, 
-	"2nd DSSD Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 5, decayEnergyBins, timeBins,
-	"2nd DSSD Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 6, decayEnergyBins, timeBins,
-	"2nd DSSD Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 7, decayEnergyBins, timeBins,
-	"2nd DSSD Ty,Ex (100ms/ch)(xkeV)");
-    // DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX_SECOND + 8, decayEnergyBins, timeBins,
-    //		       "2nd DSSD Ty,Ex (100ms/ch)(xkeV)");
+    // 780-787, time resolutions as for 750-757 above
+	histo.DeclareGranularY(DD_ENERGY_DECAY_TIME_GRANX_SECOND, decayEnergyBins,
+	    timeBins, "2nd DSSD Ty,Ex (xkeV)", 1, decayTimeResolution, "s");
     */
  
 	/*
@@ -906,14 +767,16 @@ bool Dssd4JAEAProcessor::Process(RawEvent &event)
 						plot(6, proton[0][x][y].energyF, log(betaTime[0][x][y]/10.)); // 706, Eproton vs. dt1
 						plot(7, proton[0][x][y].energyF, log(dt2/10.)); // 707, Eproton vs. dt2
 						plot(8, log(betaTime[0][x][y]/10.), log(dt2/10.));// 708
-						// output text
-						fstream outfile;
-						outfile.open("beta-decay-proton.out", std::iostream::out | std::iostream::app);
-						outfile << x << "  " << y << "  "
-								<< betaTime[0][x][y] << "  " 
-								<< proton[0][x][y].energyF << "  "
-								<< dt2 << endl;
-						outfile.close();
+						// store to the event tap (x, y, beta time, proton
+						// energy, dt2), replaces beta-decay-proton.out
+						if (betaDecayProbe_ >= 0) {
+							double values[5] = {double(x), double(y),
+												betaTime[0][x][y],
+												proton[0][x][y].energyF,
+												dt2};
+							EventTap::get()->Record(betaDecayProbe_,
+													values, 5);
+						}
 						// clear
 						implant[x][y].Clear();
 						betaTime[0][x][y] = -1;
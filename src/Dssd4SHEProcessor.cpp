@@ -16,6 +16,7 @@
 #include "DammPlotIds.hpp"
 #include "Globals.hpp"
 #include "Messenger.hpp"
+#include "MtcCycle.hpp"
 #include "Notebook.hpp"
 #include "RawEvent.hpp"
 
@@ -134,88 +135,88 @@ void Dssd4SHEProcessor::DeclarePlots(void)
 		       xBins, yBins, "DSSD position decay");
 
     /** Trace Information **/
-    DeclareHistogram2D(DD_ENERGY_POS_X_TRACE,
+    DeclareSparse2D(DD_ENERGY_POS_X_TRACE,
 		       energyBins, xBins, "DSSD E vs X from Traces");
-    DeclareHistogram2D(DD_ENERGY_POS_Y_TRACE,
+    DeclareSparse2D(DD_ENERGY_POS_Y_TRACE,
 		       energyBins, yBins, "DSSD E vs Y from Traces");
-    DeclareHistogram2D(DD_FRONTE__BACKE, energyBins2, energyBins2,
+    DeclareSparse2D(DD_FRONTE__BACKE, energyBins2, energyBins2,
             "Front vs Back energy (calib / 100)");
 
     /** Check Gain match alpha region events **/
-    DeclareHistogram2D(DD_EVENT_ENERGY__X_POSITION_IMP,
+    DeclareSparse2D(DD_EVENT_ENERGY__X_POSITION_IMP,
 		       energyBins, xBins, "DSSD X strips E vs. position");
-    DeclareHistogram2D(DD_EVENT_ENERGY__Y_POSITION_IMP,
+    DeclareSparse2D(DD_EVENT_ENERGY__Y_POSITION_IMP,
 		       energyBins, yBins, "DSSD Y strips E vs. position");
-    DeclareHistogram2D(DD_EVENT_ENERGY__X_POSITION_DEC,
+    DeclareSparse2D(DD_EVENT_ENERGY__X_POSITION_DEC,
 		       energyBins, xBins, "DSSD X strips E vs. position");
-    DeclareHistogram2D(DD_EVENT_ENERGY__Y_POSITION_DEC,
+    DeclareSparse2D(DD_EVENT_ENERGY__Y_POSITION_DEC,
 		       energyBins, yBins, "DSSD Y strips E vs. position");
     /** Check Gain match for HE events **/
-    DeclareHistogram2D(DD_EVENT_ENERGY_COMP_X_POSITION_IMP,
+    DeclareSparse2D(DD_EVENT_ENERGY_COMP_X_POSITION_IMP,
 		       energyBins2, xBins, "DSSD X strips E/100 vs. position");
-    DeclareHistogram2D(DD_EVENT_ENERGY_COMP_Y_POSITION_IMP,
+    DeclareSparse2D(DD_EVENT_ENERGY_COMP_Y_POSITION_IMP,
 		       energyBins2, yBins, "DSSD Y strips E/100 vs. position");
-    DeclareHistogram2D(DD_EVENT_ENERGY_COMP_X_POSITION_DEC,
+    DeclareSparse2D(DD_EVENT_ENERGY_COMP_X_POSITION_DEC,
 		       energyBins2, xBins, "DSSD X strips E/100 vs. position");
-    DeclareHistogram2D(DD_EVENT_ENERGY_COMP_Y_POSITION_DEC,
+    DeclareSparse2D(DD_EVENT_ENERGY_COMP_Y_POSITION_DEC,
 		       energyBins2, yBins, "DSSD Y strips E/100 vs. position");
 
     /** Check Gain match spectra via MaxEvents routine **/
 
-    DeclareHistogram2D(DD_MAXEVENT_ENERGY__X_POSITION_IMP,
+    DeclareSparse2D(DD_MAXEVENT_ENERGY__X_POSITION_IMP,
 		       energyBins, xBins, "MAXDSSD X strips E vs. position");
-    DeclareHistogram2D(DD_MAXEVENT_ENERGY__Y_POSITION_IMP,
+    DeclareSparse2D(DD_MAXEVENT_ENERGY__Y_POSITION_IMP,
 		       energyBins, yBins, "MAXDSSD Y strips E vs. position");
-    DeclareHistogram2D(DD_MAXEVENT_ENERGY__X_POSITION_DEC,
+    DeclareSparse2D(DD_MAXEVENT_ENERGY__X_POSITION_DEC,
 		       energyBins, xBins, "MAXDSSD X strips E vs. position");
-    DeclareHistogram2D(DD_MAXEVENT_ENERGY__Y_POSITION_DEC,
+    DeclareSparse2D(DD_MAXEVENT_ENERGY__Y_POSITION_DEC,
 		       energyBins, yBins, "MAXDSSD Y strips E vs. position");
 
-    DeclareHistogram2D(DD_MAXEVENT_ENERGY_COMP_X_POSITION_IMP,
+    DeclareSparse2D(DD_MAXEVENT_ENERGY_COMP_X_POSITION_IMP,
 		       energyBins2, xBins, "MAXDSSD X strips E/100 vs. position");
-    DeclareHistogram2D(DD_MAXEVENT_ENERGY_COMP_Y_POSITION_IMP,
+    DeclareSparse2D(DD_MAXEVENT_ENERGY_COMP_Y_POSITION_IMP,
 		       energyBins2, yBins, "MAXDSSD Y strips E/100 vs. position");
-    DeclareHistogram2D(DD_MAXEVENT_ENERGY_COMP_X_POSITION_DEC,
+    DeclareSparse2D(DD_MAXEVENT_ENERGY_COMP_X_POSITION_DEC,
 		       energyBins2, xBins, "MAXDSSD X strips E/100 vs. position");
-    DeclareHistogram2D(DD_MAXEVENT_ENERGY_COMP_Y_POSITION_DEC,
+    DeclareSparse2D(DD_MAXEVENT_ENERGY_COMP_Y_POSITION_DEC,
 		       energyBins2, yBins, "MAXDSSD Y strips E/100 vs. position");
 
 
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 0, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 0, energyBins, timeBins,
 		       "DSSD Ty,Ex (10ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 1, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 1, energyBins, timeBins,
 		       "DSSD Ty,Ex (100ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 2, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 2, energyBins, timeBins,
 		       "DSSD Ty,Ex (400ns/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 3, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 3, energyBins, timeBins,
 		       "DSSD Ty,Ex (1us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 4, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 4, energyBins, timeBins,
 		       "DSSD Ty,Ex (10us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 5, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 5, energyBins, timeBins,
 		       "DSSD Ty,Ex (100us/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 6, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 6, energyBins, timeBins,
 		       "DSSD Ty,Ex (1ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 7, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 7, energyBins, timeBins,
 		       "DSSD Ty,Ex (10ms/ch)(xkeV)");
-    DeclareHistogram2D(DD_ENERGY_DECAY_TIME_GRANX + 8, energyBins, timeBins,
+    DeclareSparse2D(DD_ENERGY_DECAY_TIME_GRANX + 8, energyBins, timeBins,
 		       "DSSD Ty,Ex (100ms/ch)(xkeV)");
     /** Diagnostics **/ 
-    DeclareHistogram2D(DD_ENERGY__POSX_T_MISSING,
+    DeclareSparse2D(DD_ENERGY__POSX_T_MISSING,
 		       energyBins, xBins, "DSSD T missing X strips E vs. position");
-    DeclareHistogram2D(DD_ENERGY__POSY_T_MISSING,
+    DeclareSparse2D(DD_ENERGY__POSY_T_MISSING,
 		       energyBins, yBins, "DSSD T missing Y strips E vs. position");
 
     /** Check how many strips and how far fired **/
-    DeclareHistogram2D(DD_DENERGY__DPOS_X_CORRELATED,
+    DeclareSparse2D(DD_DENERGY__DPOS_X_CORRELATED,
 		       energyBins, xBins, "DSSD dE dX correlated events");
-    DeclareHistogram2D(DD_DENERGY__DPOS_Y_CORRELATED,
+    DeclareSparse2D(DD_DENERGY__DPOS_Y_CORRELATED,
 		       energyBins, yBins, "DSSD dE dY correlated events");
     /** Pixel Correlated Events **/
-    DeclareHistogram2D(DD_CHAIN_NUM_FISSION, SB, SA, 
+    DeclareSparse2D(DD_CHAIN_NUM_FISSION, SB, SA, 
             "Event Number vs. Fission Chain Energy/10");
-    DeclareHistogram2D(DD_CHAIN_NUM_ALPHA, SB, SA, 
+    DeclareSparse2D(DD_CHAIN_NUM_ALPHA, SB, SA, 
             "Event Number vs. Alpha Chain Energy");
-    DeclareHistogram2D(DD_CHAIN_ALPHA_V_ALPHA, SB, SB,
+    DeclareSparse2D(DD_CHAIN_ALPHA_V_ALPHA, SB, SB,
 	    "First Alpha vs. Alpha Chain Energy");
 }
 
@@ -474,7 +475,7 @@ bool Dssd4SHEProcessor::Process(RawEvent &event)
     vector<ChanEvent*> mwpcEvents = 
         event.GetSummary("mcp:mcp", true)->GetList();
     int mwpc = event.GetSummary("mcp", true)->GetMult();
-    bool hasBeam = TreeCorrelator::get()->place("Beam")->status();
+    bool hasBeam = MtcCycle::get()->IsBeamOn();
 
    plot(D_MWPC_MULTI, mwpc);
 
@@ -0,0 +1,319 @@
+/** \file EventCache.cpp
+ *
+ * Cache of built and calibrated events for fast reprocessing
+ */
+#include <cstring>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include "ChanEvent.hpp"
+#include "DetectorDriver.hpp"
+#include "EventCache.hpp"
+#include "Exceptions.hpp"
+#include "Globals.hpp"
+#include "Messenger.hpp"
+#include "RawEvent.hpp"
+#include "TreeCorrelator.hpp"
+
+using namespace std;
+
+namespace {
+    /** Identifies the file type, followed by version and traces flag */
+    const char cacheMagic[8] = {'P', 'X', 'E', 'V', 'C', 'A', 'C', 'H'};
+
+    /** Kind of trace stored with the channel */
+    const uint8_t TRACE_NONE = 0;
+    const uint8_t TRACE_RAW = 1; //< packed 16-bit samples
+    const uint8_t TRACE_INT = 2; //< expanded samples (virtual channels)
+
+    /** Written in place of the number of channels at the end of a spill */
+    const uint32_t SPILL_END = 0xFFFFFFFF;
+
+    template<typename T>
+    void put(ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(ofstream& out, const string& value) {
+        put(out, (uint32_t)value.size());
+        out.write(value.data(), value.size());
+    }
+
+    template<typename T>
+    T readValue(ifstream& in) {
+        T value = T();
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+
+    string readString(ifstream& in) {
+        uint32_t length = readValue<uint32_t>(in);
+        if (!in)
+            return string();
+        string value(length, '\0');
+        if (length > 0)
+            in.read(&value[0], length);
+        return value;
+    }
+
+    /** True if the trace has samples and all of them fit the packed
+     * 16-bit form */
+    bool FitsHalfword(const Trace& trace) {
+        if (trace.empty())
+            return false;
+        for (Trace::const_iterator it = trace.begin();
+             it != trace.end(); ++it)
+            if (*it < 0 || *it > 0xFFFF)
+                return false;
+        return true;
+    }
+}
+
+EventCache* EventCache::instance = NULL;
+const uint32_t EventCache::version_;
+
+/** Instance is created upon first call */
+EventCache* EventCache::get() {
+    if (!instance) {
+        instance = new EventCache();
+    }
+    return instance;
+}
+
+EventCache::EventCache() {
+    mode_ = NONE;
+    traces_ = Globals::get()->eventCacheTraces();
+    file_name_ = Globals::get()->eventCacheFile();
+    string mode = Globals::get()->eventCacheMode();
+
+    if (file_name_ == "")
+        return;
+
+    if (mode == "write") {
+        out_.open(file_name_.c_str(), ios::binary | ios::trunc);
+        if (!out_.good())
+            throw IOException("EventCache: could not open file "
+                              + file_name_);
+        out_.write(cacheMagic, sizeof(cacheMagic));
+        put(out_, version_);
+        put(out_, (uint8_t)traces_);
+        mode_ = WRITE;
+    } else if (mode == "replay") {
+        mode_ = REPLAY;
+    }
+}
+
+EventCache::~EventCache() {
+    if (out_.is_open())
+        out_.close();
+}
+
+void EventCache::Write(const vector<ChanEvent*>& event) {
+    if (mode_ != WRITE)
+        return;
+    put(out_, (uint32_t)event.size());
+    for (vector<ChanEvent*>::const_iterator it = event.begin();
+         it != event.end(); ++it)
+        WriteChannel(*it);
+}
+
+void EventCache::EndSpill() {
+    if (mode_ != WRITE)
+        return;
+    put(out_, SPILL_END);
+    out_.flush();
+}
+
+void EventCache::WriteChannel(const ChanEvent* chan) {
+    put(out_, (int32_t)chan->modNum);
+    put(out_, (int32_t)chan->chanNum);
+    put(out_, chan->energy);
+    put(out_, chan->calEnergy);
+    put(out_, chan->calTime);
+    put(out_, chan->correctedTime);
+    put(out_, chan->highResTime);
+    put(out_, chan->time);
+    put(out_, chan->eventTime);
+    put(out_, chan->trigTime);
+    put(out_, chan->cfdTime);
+    put(out_, chan->eventTimeLo);
+    put(out_, chan->eventTimeHi);
+    put(out_, chan->runTime0);
+    put(out_, chan->runTime1);
+    put(out_, chan->runTime2);
+    for (int i = 0; i < ChanEvent::numQdcs; ++i)
+        put(out_, chan->qdcValue[i]);
+    for (int i = 0; i < ChanEvent::numEsums; ++i)
+        put(out_, chan->esumValue[i]);
+    uint8_t flags = (chan->virtualChannel ? 1 : 0) |
+                    (chan->pileupBit ? 2 : 0) |
+                    (chan->saturatedBit ? 4 : 0);
+    put(out_, flags);
+
+    /** Trace analysis results are kept in the (unexpanded) trace object */
+    const Trace& trace = chan->trace;
+    const map<string, double>& doubles = trace.GetDoubleValues();
+    put(out_, (uint32_t)doubles.size());
+    for (map<string, double>::const_iterator it = doubles.begin();
+         it != doubles.end(); ++it) {
+        putString(out_, it->first);
+        put(out_, it->second);
+    }
+    const map<string, int>& ints = trace.GetIntValues();
+    put(out_, (uint32_t)ints.size());
+    for (map<string, int>::const_iterator it = ints.begin();
+         it != ints.end(); ++it) {
+        putString(out_, it->first);
+        put(out_, (int32_t)it->second);
+    }
+
+    if (!traces_)
+        return;
+    if (!chan->rawTrace.empty()) {
+        put(out_, TRACE_RAW);
+        put(out_, (uint32_t)chan->rawTrace.size());
+        out_.write(reinterpret_cast<const char*>(&chan->rawTrace[0]),
+                   chan->rawTrace.size() * sizeof(pixie::halfword_t));
+    } else if (FitsHalfword(trace)) {
+        /** Expanded pixie trace, the packed samples were released */
+        put(out_, TRACE_RAW);
+        put(out_, (uint32_t)trace.size());
+        for (Trace::const_iterator it = trace.begin();
+             it != trace.end(); ++it)
+            put(out_, (pixie::halfword_t)(*it));
+    } else if (!trace.empty()) {
+        put(out_, TRACE_INT);
+        put(out_, (uint32_t)trace.size());
+        for (Trace::const_iterator it = trace.begin();
+             it != trace.end(); ++it)
+            put(out_, (int32_t)(*it));
+    } else {
+        put(out_, TRACE_NONE);
+    }
+}
+
+ChanEvent* EventCache::ReadChannel(ifstream& in, bool withTraces) {
+    ChanEvent* chan = new ChanEvent();
+    chan->modNum = readValue<int32_t>(in);
+    chan->chanNum = readValue<int32_t>(in);
+    chan->energy = readValue<double>(in);
+    chan->calEnergy = readValue<double>(in);
+    chan->calTime = readValue<double>(in);
+    chan->correctedTime = readValue<double>(in);
+    chan->highResTime = readValue<double>(in);
+    chan->time = readValue<double>(in);
+    chan->eventTime = readValue<double>(in);
+    chan->trigTime = readValue<pixie::word_t>(in);
+    chan->cfdTime = readValue<pixie::word_t>(in);
+    chan->eventTimeLo = readValue<pixie::word_t>(in);
+    chan->eventTimeHi = readValue<pixie::word_t>(in);
+    chan->runTime0 = readValue<pixie::word_t>(in);
+    chan->runTime1 = readValue<pixie::word_t>(in);
+    chan->runTime2 = readValue<pixie::word_t>(in);
+    for (int i = 0; i < ChanEvent::numQdcs; ++i)
+        chan->qdcValue[i] = readValue<pixie::word_t>(in);
+    for (int i = 0; i < ChanEvent::numEsums; ++i)
+        chan->esumValue[i] = readValue<pixie::word_t>(in);
+    uint8_t flags = readValue<uint8_t>(in);
+    chan->virtualChannel = flags & 1;
+    chan->pileupBit = flags & 2;
+    chan->saturatedBit = flags & 4;
+
+    uint32_t numDoubles = readValue<uint32_t>(in);
+    for (uint32_t i = 0; i < numDoubles && in; ++i) {
+        string name = readString(in);
+        chan->trace.SetValue(name, readValue<double>(in));
+    }
+    uint32_t numInts = readValue<uint32_t>(in);
+    for (uint32_t i = 0; i < numInts && in; ++i) {
+        string name = readString(in);
+        chan->trace.SetValue(name, (int)readValue<int32_t>(in));
+    }
+
+    if (withTraces && in) {
+        uint8_t kind = readValue<uint8_t>(in);
+        if (kind == TRACE_RAW) {
+            uint32_t size = readValue<uint32_t>(in);
+            chan->rawTrace.resize(size);
+            if (size > 0)
+                in.read(reinterpret_cast<char*>(&chan->rawTrace[0]),
+                        size * sizeof(pixie::halfword_t));
+        } else if (kind == TRACE_INT) {
+            uint32_t size = readValue<uint32_t>(in);
+            for (uint32_t i = 0; i < size && in; ++i)
+                chan->trace.push_back(readValue<int32_t>(in));
+            chan->traceExpanded = true;
+        }
+    }
+
+    if (!in) {
+        delete chan;
+        return NULL;
+    }
+    return chan;
+}
+
+unsigned long EventCache::Replay(RawEvent& rawev, void (*endSpill)()) {
+    Messenger m;
+    m.start("Replaying events from " + file_name_);
+
+    ifstream in(file_name_.c_str(), ios::binary);
+    char magic[sizeof(cacheMagic)];
+    in.read(magic, sizeof(magic));
+    uint32_t version = readValue<uint32_t>(in);
+    bool withTraces = readValue<uint8_t>(in) != 0;
+    if (!in || memcmp(magic, cacheMagic, sizeof(magic)) != 0 ||
+        version != version_) {
+        m.fail();
+        throw IOException("EventCache: " + file_name_ +
+                          " is not an event cache of a known version");
+    }
+
+    DetectorDriver* driver = DetectorDriver::get();
+    set<string> usedDetectors;
+    vector<ChanEvent*> event;
+    unsigned long numEvents = 0;
+    bool inSpill = false;
+    while (true) {
+        uint32_t numChannels = readValue<uint32_t>(in);
+        if (!in)
+            break;
+        if (numChannels == SPILL_END) {
+            endSpill();
+            inSpill = false;
+            continue;
+        }
+        inSpill = true;
+        for (uint32_t i = 0; i < numChannels; ++i) {
+            ChanEvent* chan = ReadChannel(in, withTraces);
+            if (chan == NULL)
+                break;
+            event.push_back(chan);
+            rawev.AddChan(chan);
+        }
+        if (event.size() != numChannels) {
+            m.warning("EventCache: truncated event at the end of "
+                      + file_name_);
+        } else {
+            driver->ProcessEvent(rawev, true);
+            ++numEvents;
+        }
+
+        rawev.Zero(usedDetectors);
+        TreeCorrelator::get()->resetPlaces();
+        for (vector<ChanEvent*>::iterator it = event.begin();
+             it != event.end(); ++it)
+            delete *it;
+        event.clear();
+    }
+    /** Cache written by an interrupted scan */
+    if (inSpill)
+        endSpill();
+
+    stringstream ss;
+    ss << "Replayed " << numEvents << " events";
+    m.detail(ss.str());
+    m.done();
+    return numEvents;
+}
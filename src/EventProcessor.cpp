@@ -137,6 +137,24 @@ void EventProcessor::EndProcess(void)
     times(&tmsBegin);
 }
 
+/** This function binds the variables holding the data generated by this
+ * event processor to columns of the ColumnProcessor output, returns
+ * true if any column was added.
+ */
+bool EventProcessor::AddColumns(ColumnWriter *)
+{
+    return false;
+}
+
+/** This function is called before each row of the columnar output is
+ * written. As for ROOT branches, the bound variables must be zeroed for
+ * events where no detectors of interest to this processor triggered.
+ */
+void EventProcessor::FillColumns(void)
+{
+    // Do nothing
+}
+
 #ifdef useroot
 /** This functions adds the branch to the tree that will be responsible 
  * for holding the data generated by this event processor
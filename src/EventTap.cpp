@@ -0,0 +1,221 @@
+/** \file EventTap.cpp
+ *
+ * Filtered capture of raw channels, built events and processor values
+ */
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include "AsyncWriter.hpp"
+#include "ChanEvent.hpp"
+#include "Configuration.hpp"
+#include "DetectorDriver.hpp"
+#include "EventTap.hpp"
+#include "Exceptions.hpp"
+#include "Globals.hpp"
+#include "Messenger.hpp"
+
+using namespace std;
+
+namespace {
+    /** Identifies the file type, followed by version, record size
+     * and the probe names */
+    const char tapMagic[8] = {'P', 'X', 'E', 'V', 'T', 'A', 'P', '1'};
+
+    template<typename T>
+    void put(string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+EventTap* EventTap::instance = NULL;
+bool EventTap::enabled_ = false;
+const uint32_t EventTap::version_;
+
+/** Instance is created upon first call */
+EventTap* EventTap::get() {
+    if (!instance) {
+        instance = new EventTap();
+    }
+    return instance;
+}
+
+EventTap::EventTap() {
+    used_ = 0;
+    events_ = 0;
+
+    pugi::xml_node tap = Configuration::get()->section("EventTap");
+    if (!tap)
+        return;
+
+    file_name_ = tap.attribute("file").as_string("tap.bin");
+    int records = tap.attribute("records").as_int(65536);
+    if (records <= 0) {
+        stringstream ss;
+        ss << "EventTap: records must be positive, got " << records;
+        throw GeneralException(ss.str());
+    }
+
+    const double inf = numeric_limits<double>::infinity();
+    for (pugi::xml_node node = tap.child("Filter"); node;
+         node = node.next_sibling("Filter")) {
+        Filter f;
+        string kind = node.attribute("kind").as_string("both");
+        if (kind != "raw" && kind != "built" && kind != "both") {
+            stringstream ss;
+            ss << "EventTap: unknown filter kind '" << kind << "'";
+            throw GeneralException(ss.str());
+        }
+        f.raw = (kind != "built");
+        f.built = (kind != "raw");
+        f.type = node.attribute("type").as_string("");
+        f.subtype = node.attribute("subtype").as_string("");
+        f.emin = node.attribute("emin").as_double(-inf);
+        f.emax = node.attribute("emax").as_double(inf);
+        f.start = node.attribute("start").as_double(-inf);
+        f.stop = node.attribute("stop").as_double(inf);
+        f.wallStart = node.attribute("wall_start").as_double(-inf);
+        f.wallStop = node.attribute("wall_stop").as_double(inf);
+        f.firstEvent = node.attribute("first_event").as_double(-inf);
+        f.lastEvent = node.attribute("last_event").as_double(inf);
+        filters_.push_back(f);
+    }
+
+    for (pugi::xml_node node = tap.child("Probe"); node;
+         node = node.next_sibling("Probe")) {
+        probes_.push_back(node.attribute("name").as_string());
+    }
+
+    buffer_.resize(records);
+
+    string header(tapMagic, sizeof(tapMagic));
+    put(header, version_);
+    put(header, (uint32_t)sizeof(TapRecord));
+    put(header, (uint32_t)probes_.size());
+    for (vector<string>::const_iterator it = probes_.begin();
+         it != probes_.end(); ++it) {
+        put(header, (uint32_t)it->size());
+        header.append(*it);
+    }
+    AsyncWriter::get()->Open(file_name_, true);
+    AsyncWriter::get()->Write(file_name_, header);
+    /* Registered after the AsyncWriter, so it runs before its shutdown */
+    atexit(FlushAtExit);
+
+    enabled_ = true;
+
+    Messenger m;
+    stringstream ss;
+    ss << "Event tap: " << filters_.size() << " filter(s), "
+       << probes_.size() << " probe(s) to " << file_name_;
+    m.detail(ss.str());
+}
+
+void EventTap::FlushAtExit() {
+    try {
+        if (instance != NULL)
+            instance->Flush();
+    } catch (IOException &err) {
+        Messenger m;
+        m.warning(err.what());
+    }
+}
+
+bool EventTap::Pass(const ChanEvent* chan, Kind kind) const {
+    const Identifier& id = chan->GetChanID();
+    double energy = (kind == RAW) ? chan->GetEnergy() : chan->GetCalEnergy();
+    double time = chan->GetTime() * Globals::get()->clockInSeconds();
+
+    for (vector<Filter>::const_iterator it = filters_.begin();
+         it != filters_.end(); ++it) {
+        if (kind == RAW ? !it->raw : !it->built)
+            continue;
+        if (!it->type.empty() && it->type != id.GetType())
+            continue;
+        if (!it->subtype.empty() && it->subtype != id.GetSubtype())
+            continue;
+        if (energy < it->emin || energy > it->emax)
+            continue;
+        if (time < it->start || time > it->stop)
+            continue;
+        if (events_ < it->firstEvent || events_ > it->lastEvent)
+            continue;
+        if (it->wallStart > -numeric_limits<double>::infinity() ||
+            it->wallStop < numeric_limits<double>::infinity()) {
+            double wall = DetectorDriver::get()->GetWallTime(chan->GetTime());
+            if (wall < it->wallStart || wall > it->wallStop)
+                continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+TapRecord& EventTap::Next(Kind kind, unsigned id) {
+    if (used_ == buffer_.size())
+        Flush();
+    TapRecord& record = buffer_[used_++];
+    memset(&record, 0, sizeof(TapRecord));
+    record.event = events_;
+    record.kind = kind;
+    record.id = id;
+    return record;
+}
+
+void EventTap::Raw(const ChanEvent* chan) {
+    if (!Pass(chan, RAW))
+        return;
+    TapRecord& record = Next(RAW, chan->GetID());
+    record.values[0] = chan->GetTime();
+    record.values[1] = chan->GetEnergy();
+    record.values[2] = chan->GetCfdPhase();
+    record.values[3] = chan->IsPileup();
+    record.values[4] = chan->IsSaturated();
+}
+
+void EventTap::Built(const vector<ChanEvent*>& event) {
+    bool pass = false;
+    for (vector<ChanEvent*>::const_iterator it = event.begin();
+         it != event.end() && !pass; ++it)
+        pass = Pass(*it, BUILT);
+
+    if (pass) {
+        for (vector<ChanEvent*>::const_iterator it = event.begin();
+             it != event.end(); ++it) {
+            TapRecord& record = Next(BUILT, (*it)->GetID());
+            record.values[0] = (*it)->GetTime();
+            record.values[1] = (*it)->GetEnergy();
+            record.values[2] = (*it)->GetCalEnergy();
+            record.values[3] = (*it)->GetCorrectedTime();
+            record.values[4] = (*it)->GetHighResTime();
+        }
+    }
+    ++events_;
+}
+
+int EventTap::Probe(const string& name) const {
+    for (unsigned i = 0; i < probes_.size(); ++i)
+        if (probes_[i] == name)
+            return i;
+    return -1;
+}
+
+void EventTap::Record(int probe, const double* values, unsigned n) {
+    if (probe < 0 || probe >= (int)probes_.size())
+        return;
+    TapRecord& record = Next(PROBE, probe);
+    if (n > sizeof(record.values) / sizeof(double))
+        n = sizeof(record.values) / sizeof(double);
+    for (unsigned i = 0; i < n; ++i)
+        record.values[i] = values[i];
+}
+
+void EventTap::Flush() {
+    if (used_ == 0)
+        return;
+    string data(reinterpret_cast<const char*>(&buffer_[0]),
+                used_ * sizeof(TapRecord));
+    used_ = 0;
+    AsyncWriter::get()->Write(file_name_, data);
+}
@@ -18,6 +18,7 @@
 #include <cstdlib>
 
 
+#include "MtcCycle.hpp"
 #include "Plots.hpp"
 #include "PlotsRegister.hpp"
 #include "DammPlotIds.hpp"
@@ -116,11 +117,11 @@ void Ge4Hen3Processor::DeclarePlots(void)
                        "Gamma addback neutron gated");
     DeclareHistogram1D(neutron::D_ADD_ENERGY_TOTAL, energyBins1,
                        "Gamma total addback neutron gated");
-    DeclareHistogram2D(neutron::DD_ENERGY, energyBins2, energyBins2,
+    DeclareSymmetric2D(neutron::DD_ENERGY, energyBins2,
                        "Gamma gamma neutron gated");
     DeclareHistogram2D(neutron::DD_ENERGY_NEUTRON_LOC, SD, S6,
                        "Gamma energy vs neutron location");
-    DeclareHistogram2D(neutron::DD_ADD_ENERGY, energyBins2, energyBins2,
+    DeclareSymmetric2D(neutron::DD_ADD_ENERGY, energyBins2,
                        "Gamma gamma addback neutron gated");
     DeclareHistogramGranY(neutron::DD_ENERGY__TIMEX, energyBins2, granTimeBins,
                           "E - Time neutron gated", 2, timeResolution, "s");
@@ -144,10 +145,10 @@ void Ge4Hen3Processor::DeclarePlots(void)
                        "Gamma addback beta neutron gated");
     DeclareHistogram1D(neutron::betaGated::D_ADD_ENERGY_TOTAL, energyBins1,
                        "Gamma total addback beta neutron gated");
-    DeclareHistogram2D(neutron::betaGated::DD_ENERGY, energyBins2, energyBins2,
+    DeclareSymmetric2D(neutron::betaGated::DD_ENERGY, energyBins2,
                        "Gamma gamma beta neutron gated");
-    DeclareHistogram2D(neutron::betaGated::DD_ADD_ENERGY,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(neutron::betaGated::DD_ADD_ENERGY,
+                       energyBins2,
                        "Gamma gamma addback beta neutron gated");
     DeclareHistogramGranY(neutron::betaGated::DD_ENERGY__TIMEX,
                           energyBins2, granTimeBins,
@@ -217,7 +218,7 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
      *  This condition will therefore skip events registered during 
      *  tape movement period and before the end of move and the beam start
      */
-    if (!TreeCorrelator::get()->place("Cycle")->status()) {
+    if (!MtcCycle::get()->IsInCycle()) {
         for (vector<ChanEvent*>::iterator it = geEvents_.begin(); 
         it != geEvents_.end(); ++it) {
             ChanEvent* chan = *it;
@@ -232,10 +233,10 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
     double clockInSeconds = Globals::get()->clockInSeconds();
 
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = MtcCycle::get()->CycleTime();
     
     // beamOn is true for beam on and false for beam off
-    bool beamOn =  TreeCorrelator::get()->place("Beam")->status();
+    bool beamOn =  MtcCycle::get()->IsBeamOn();
 
     plot(neutron::D_MULT, geEvents_.size());
 
@@ -254,17 +255,17 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
 
         plot(neutron::D_ENERGY, gEnergy);
         granploty(neutron::DD_ENERGY__TIMEX,
-                    gEnergy, decayTime, timeResolution);
+                    gEnergy, decayTime);
 
         if (beamOn) {
             granploty(neutron::DD_ENERGY__TIMEX_GROW, 
-                    gEnergy, decayTime, timeResolution);
+                    gEnergy, decayTime);
         } else {
             double decayTimeOff = (gTime - 
-                    TreeCorrelator::get()->place("Beam")->last().time) *
+                    MtcCycle::get()->BeamTime()) *
                     clockInSeconds;
             granploty(neutron::DD_ENERGY__TIMEX_DECAY, 
-                    gEnergy, decayTimeOff, timeResolution);
+                    gEnergy, decayTimeOff);
         }
 
         double gb_dtime = numeric_limits<double>::max();
@@ -275,7 +276,7 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
 			if (GoodGammaBeta(gb_dtime)) {
                 plot(neutron::betaGated::D_ENERGY_PROMPT, gEnergy);
                 granploty(neutron::betaGated::DD_ENERGY__TIMEX,
-                            gEnergy, decayTime, timeResolution);
+                            gEnergy, decayTime);
             }
 		}
 
@@ -290,13 +291,13 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
         if (neutron_count > 1) {
             plot(multiNeutron::D_ENERGY, gEnergy);
             granploty(multiNeutron::DD_ENERGY__TIMEX,
-                      gEnergy, decayTime, timeResolution);
+                      gEnergy, decayTime);
             if (hasBeta) {
                 plot(multiNeutron::betaGated::D_ENERGY, gEnergy);
                 if (GoodGammaBeta(gb_dtime)) {
                     plot(multiNeutron::betaGated::D_ENERGY_PROMPT, gEnergy);
                     granploty(multiNeutron::betaGated::DD_ENERGY__TIMEX,
-                            gEnergy, decayTime, timeResolution);
+                            gEnergy, decayTime);
                 }
             }
         }
@@ -360,7 +361,7 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
 
             plot(neutron::D_ADD_ENERGY, gEnergy);
             granploty(neutron::DD_ADD_ENERGY__TIMEX, gEnergy,
-                      decayTime, timeResolution);
+                      decayTime);
 
             double gb_dtime = numeric_limits<double>::max();
             if (hasBeta) {
@@ -371,16 +372,16 @@ bool Ge4Hen3Processor::Process(RawEvent &event) {
             if (hasBeta && GoodGammaBeta(gb_dtime)) {
                 plot(neutron::betaGated::D_ADD_ENERGY, gEnergy);
                 granploty(neutron::betaGated::DD_ADD_ENERGY__TIMEX,
-                          gEnergy, decayTime, timeResolution);
+                          gEnergy, decayTime);
             }
             if (neutron_count > 1) {
                 plot(multiNeutron::D_ADD_ENERGY, gEnergy);
                 granploty(multiNeutron::DD_ADD_ENERGY__TIMEX,
-                          gEnergy, decayTime, timeResolution);
+                          gEnergy, decayTime);
                 if (hasBeta && GoodGammaBeta(gb_dtime)) {
                     plot(multiNeutron::betaGated::D_ADD_ENERGY, gEnergy);
                     granploty(multiNeutron::betaGated::DD_ADD_ENERGY__TIMEX,
-                              gEnergy, decayTime, timeResolution);
+                              gEnergy, decayTime);
                 }
             }
 
@@ -21,10 +21,12 @@
 
 #include "GeProcessor.hpp"
 
+#include "Configuration.hpp"
 #include "DammPlotIds.hpp"
 #include "DetectorLibrary.hpp"
 #include "Exceptions.hpp"
 #include "Messenger.hpp"
+#include "MtcCycle.hpp"
 #include "Notebook.hpp"
 #include "Plots.hpp"
 #include "PlotsRegister.hpp"
@@ -34,26 +36,52 @@ using namespace std;
 using namespace dammIds::ge;
 
 EventData GeProcessor::BestBetaForGamma(double gTime) {
-    PlaceOR* betas = dynamic_cast<PlaceOR*>(
-                        TreeCorrelator::get()->place("Beta"));
-    unsigned sz = betas->info_.size();
+    if (betaPlace_ < 0)
+        betaPlace_ = TreeCorrelator::get()->handle("Beta");
+    const EventFifo& betas =
+        TreeCorrelator::get()->place((unsigned)betaPlace_)->info_;
+    unsigned sz = betas.size();
 
     if (sz == 0)
         return EventData(-1);
 
     double bestTime = numeric_limits<double>::max();
     unsigned bestIndex = -1;
+    if (betas.timeOrdered()) {
+        /** Binary search for the first beta not earlier than the gamma,
+         * the best one is either this one or the one before. As in the
+         * scan below, the most recent beta wins if differences are equal. */
+        unsigned low = 0;
+        unsigned high = sz;
+        while (low < high) {
+            unsigned mid = low + (high - low) / 2;
+            if (betas[mid].time < gTime)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if (low < sz) {
+            unsigned last = low;
+            while (last + 1 < sz && betas[last + 1].time == betas[low].time)
+                ++last;
+            bestTime = gTime - betas[last].time;
+            bestIndex = last;
+        }
+        if (low > 0 && abs(gTime - betas[low - 1].time) < abs(bestTime))
+            bestIndex = low - 1;
+        return betas[bestIndex];
+    }
+
     for (int index = sz - 1; index >= 0; --index) {
-        double dtime = (gTime - betas->info_.at(index).time);
+        double dtime = (gTime - betas[index].time);
         if (abs(dtime) < abs(bestTime)) {
             bestTime = dtime;
             bestIndex = index;
         }
     }
-    return betas->info_.at(bestIndex);
+    return betas.at(bestIndex);
 }
 
-
 bool GeProcessor::GoodGammaBeta(double gb_dtime) {
     if (abs(gb_dtime) > gammaBetaLimit_)
         return false;
@@ -61,14 +89,6 @@ bool GeProcessor::GoodGammaBeta(double gb_dtime) {
 }
 
 
-// useful function for symmetrically incrementing 2D plots
-void GeProcessor::symplot(int dammID, double bin1, double bin2)
-{
-    plot(dammID, bin1, bin2);
-    plot(dammID, bin2, bin1);
-}
-
-
 GeProcessor::GeProcessor(double gammaThreshold, double lowRatio,
                          double highRatio, double subEventWindow,
                          double gammaBetaLimit, double gammaGammaLimit,
@@ -77,6 +97,7 @@ GeProcessor::GeProcessor(double gammaThreshold, double lowRatio,
                          EventProcessor(OFFSET, RANGE, "ge"),
                          leafToClover()
 {
+    betaPlace_ = -1;
     associatedTypes.insert("ge"); // associate with germanium detectors
 
     gammaThreshold_ = gammaThreshold;
@@ -107,16 +128,8 @@ GeProcessor::GeProcessor(double gammaThreshold, double lowRatio,
     Messenger m;
     m.detail("Loading Gamma-gamma gates", 1);
 
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file("Config.xml");
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file Config.xml";
-        ss << " : " << result.description();
-        throw IOException(ss.str());
-    }
-
-    pugi::xml_node gamma_gates = doc.child("Configuration").child("GammaGates");
+    pugi::xml_node gamma_gates =
+        Configuration::get()->section("GammaGates");
     for (pugi::xml_node gate = gamma_gates.child("Gate"); gate;
          gate = gate.next_sibling("Gate")) {
         vector<LineGate> vg;
@@ -185,6 +198,23 @@ void GeProcessor::DeclarePlots(void)
         cloverChans++;
     }
 
+    /** Location indexed tables for the event by event lookups,
+     * unknown locations belong to clover 0 as with the map */
+    const set<int> &lowLocations = modChan->GetLocations("ge",
+                                                         "clover_low");
+    int maxLocation = -1;
+    if (!cloverLocations.empty())
+        maxLocation = max(maxLocation, *cloverLocations.rbegin());
+    if (!lowLocations.empty())
+        maxLocation = max(maxLocation, *lowLocations.rbegin());
+    cloverByLocation_.assign(maxLocation + 1, 0);
+    for (map<int, int>::const_iterator it = leafToClover.begin();
+         it != leafToClover.end(); ++it) {
+        if (it->first >= 0)
+            cloverByLocation_[it->first] = it->second;
+    }
+    lowByLocation_.assign(maxLocation + 1, (ChanEvent*)NULL);
+
     if (cloverChans % chansPerClover != 0) {
         stringstream ss;
         ss << " There does not appear to be the proper number of"
@@ -291,48 +321,48 @@ void GeProcessor::DeclarePlots(void)
                     energyBins1, ss.str().c_str());
     }
 
-    DeclareHistogram2D(DD_ENERGY, energyBins2, energyBins2, "Gamma gamma");
-    DeclareHistogram2D(DD_ENERGY_PROMPT, energyBins2, energyBins2,
+    DeclareSymmetric2D(DD_ENERGY, energyBins2, "Gamma gamma");
+    DeclareSymmetric2D(DD_ENERGY_PROMPT, energyBins2,
                        "Gamma gamma prompt");
-    DeclareHistogram2D(DD_ENERGY_CGATE1,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(DD_ENERGY_CGATE1,
+                       energyBins2,
                        "Gamma gamma cycle gate 1");
-    DeclareHistogram2D(DD_ENERGY_CGATE2,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(DD_ENERGY_CGATE2,
+                       energyBins2,
                        "Gamma gamma cycle gate 2");
 
-    DeclareHistogram2D(betaGated::DD_ENERGY,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(betaGated::DD_ENERGY,
+                       energyBins2,
                        "Gamma gamma beta prompt gated");
-    DeclareHistogram2D(betaGated::DD_ENERGY_PROMPT,
-                       energyBins2, energyBins2, 
+    DeclareSymmetric2D(betaGated::DD_ENERGY_PROMPT,
+                       energyBins2, 
                        "Gamma gamma prompt beta prompt gated");
-    DeclareHistogram2D(betaGated::DD_ENERGY_BDELAYED,
-                       energyBins2, energyBins2, 
+    DeclareSymmetric2D(betaGated::DD_ENERGY_BDELAYED,
+                       energyBins2, 
                        "Beta-gated gamma gamma - beta delayed");
 
-    DeclareHistogram2D(betaGated::DD_ENERGY_CGATE1,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(betaGated::DD_ENERGY_CGATE1,
+                       energyBins2,
                        "Beta gated gamma gamma cycle gate 1");
-    DeclareHistogram2D(betaGated::DD_ENERGY_CGATE2,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(betaGated::DD_ENERGY_CGATE2,
+                       energyBins2,
                        "Beta gated gamma gamma cycle gate 2");
 
-    DeclareHistogram2D(DD_ADD_ENERGY,
-                       energyBins2, energyBins2, "Gamma gamma addback");
-    DeclareHistogram2D(multi::DD_ADD_ENERGY,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(DD_ADD_ENERGY,
+                       energyBins2, "Gamma gamma addback");
+    DeclareSymmetric2D(multi::DD_ADD_ENERGY,
+                       energyBins2,
                        "Gamma gamma addback multi-gated");
-    DeclareHistogram2D(betaGated::DD_ADD_ENERGY,
-            energyBins2, energyBins2, "Beta-gated gamma-gamma addback");
-    DeclareHistogram2D(multi::betaGated::DD_ADD_ENERGY,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(betaGated::DD_ADD_ENERGY,
+            energyBins2, "Beta-gated gamma-gamma addback");
+    DeclareSymmetric2D(multi::betaGated::DD_ADD_ENERGY,
+                       energyBins2,
                        "Beta-gated gamma-gamma addback multi-gated");
-    DeclareHistogram2D(betaGated::DD_ADD_ENERGY_PROMPT,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(betaGated::DD_ADD_ENERGY_PROMPT,
+                       energyBins2,
                        "Beta-gated Gamma gamma addback beta-prompt");
-    DeclareHistogram2D(multi::betaGated::DD_ADD_ENERGY_PROMPT,
-                       energyBins2, energyBins2,
+    DeclareSymmetric2D(multi::betaGated::DD_ADD_ENERGY_PROMPT,
+                       energyBins2,
                     "Beta-gated gamma-gamma addback multi-gated beta-prompt");
 
     DeclareHistogram2D(
@@ -407,6 +437,16 @@ bool GeProcessor::PreProcess(RawEvent &event) {
     static const vector<ChanEvent*> &lowEvents  = 
         event.GetSummary("ge:clover_low", true)->GetList();
 
+    /** Index of the low gain events by location, the first event at
+     * a location is used for the matching */
+    for (vector<ChanEvent*>::const_iterator itLow = lowEvents.begin();
+         itLow != lowEvents.end(); ++itLow) {
+        int location = (*itLow)->GetChanID().GetLocation();
+        if (location >= 0 && location < (int)lowByLocation_.size() &&
+            lowByLocation_[location] == NULL)
+            lowByLocation_[location] = *itLow;
+    }
+
     /** Only the high gain events are going to be used. The events where
      * low/high gain mismatches, saturation or pileup is marked are rejected
      */
@@ -417,20 +457,24 @@ bool GeProcessor::PreProcess(RawEvent &event) {
             continue;
 
         // find the matching low gain event
-        vector <ChanEvent*>::const_iterator itLow = lowEvents.begin();
-        for (; itLow != lowEvents.end(); itLow++) {
-            if ( (*itLow)->GetChanID().GetLocation() == location ) {
-                break;
-            }
-        }
-        if ( itLow != lowEvents.end() ) {
-            double ratio = (*itHigh)->GetEnergy() / (*itLow)->GetEnergy();
+        ChanEvent* low = NULL;
+        if (location >= 0 && location < (int)lowByLocation_.size())
+            low = lowByLocation_[location];
+        if (low != NULL) {
+            double ratio = (*itHigh)->GetEnergy() / low->GetEnergy();
             if (ratio < lowRatio_ || ratio > highRatio_)
                 continue;
         }
         geEvents_.push_back(*itHigh);
     }
 
+    for (vector<ChanEvent*>::const_iterator itLow = lowEvents.begin();
+         itLow != lowEvents.end(); ++itLow) {
+        int location = (*itLow)->GetChanID().GetLocation();
+        if (location >= 0 && location < (int)lowByLocation_.size())
+            lowByLocation_[location] = NULL;
+    }
+
     // now we sort the germanium events according to their corrected time
     sort(geEvents_.begin(), geEvents_.end(), CompareCorrectedTime);
 
@@ -449,7 +493,7 @@ bool GeProcessor::PreProcess(RawEvent &event) {
         ChanEvent *chan = *it;
         double energy = chan->GetCalEnergy(); 
         double time = chan->GetCorrectedTime();
-        int clover = leafToClover[chan->GetChanID().GetLocation()];
+        int clover = CloverOf(chan->GetChanID().GetLocation());
 
         /**
         * Do not take into account events with too low energy
@@ -491,17 +535,17 @@ bool GeProcessor::Process(RawEvent &event) {
     double clockInSeconds = Globals::get()->clockInSeconds();
 
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = MtcCycle::get()->CycleTime();
 
     // beamOn is true for beam on and false for beam off
-    bool beamOn =  TreeCorrelator::get()->place("Beam")->status();
+    bool beamOn =  MtcCycle::get()->IsBeamOn();
     bool hasBeta = TreeCorrelator::get()->place("Beta")->status();
 
     /** Place Cycle is activated by BeamOn event and deactivated by TapeMove
      *  This condition will therefore skip events registered during 
      *  tape movement period and before the end of move and the beam start
      */
-    if (!TreeCorrelator::get()->place("Cycle")->status()) {
+    if (!MtcCycle::get()->IsInCycle()) {
         for (vector<ChanEvent*>::iterator it = geEvents_.begin(); 
         it != geEvents_.end(); ++it) {
             ChanEvent* chan = *it;
@@ -531,11 +575,11 @@ bool GeProcessor::Process(RawEvent &event) {
 
         double gTime = chan->GetCorrectedTime();
         double decayTime = (gTime - cycleTime) * clockInSeconds;
-        int det = leafToClover[chan->GetChanID().GetLocation()];
+        int det = CloverOf(chan->GetChanID().GetLocation());
 
         plot(D_ENERGY, gEnergy);
         plot(D_ENERGY_CLOVERX + det, gEnergy);
-        granploty(DD_ENERGY__TIMEX, gEnergy, decayTime, timeResolution);
+        granploty(DD_ENERGY__TIMEX, gEnergy, decayTime);
 
         double gb_dtime = numeric_limits<double>::max();
         if (hasBeta) {
@@ -555,21 +599,21 @@ bool GeProcessor::Process(RawEvent &event) {
                 plot(betaGated::D_ENERGY_PROMPT, gEnergy);
                 plot(betaGated::D_ENERGY_CLOVERX + det, gEnergy);
                 granploty(betaGated::DD_ENERGY__TIMEX, 
-                          gEnergy, decayTime, timeResolution);
+                          gEnergy, decayTime);
 
                 if (beamOn) {
                     granploty(betaGated::DD_ENERGY__TIMEX_GROW, 
-                            gEnergy, decayTime, timeResolution);
+                            gEnergy, decayTime);
                 } else {
                     /** Beam deque should be updated upon beam off so
                     * measure time from that point
                     * (t = 0 is time beam went off)
                     */
                     double decayTimeOff = (gTime - 
-                         TreeCorrelator::get()->place("Beam")->last().time) *
+                         MtcCycle::get()->BeamTime()) *
                          clockInSeconds;
                     granploty(betaGated::DD_ENERGY__TIMEX_DECAY, 
-                            gEnergy, decayTimeOff, timeResolution);
+                            gEnergy, decayTimeOff);
                 }
 
                 // individual beta gamma coinc spectra for each beta detector
@@ -588,7 +632,7 @@ bool GeProcessor::Process(RawEvent &event) {
             ChanEvent* chan2 = *it2;
 
             double gEnergy2 = chan2->GetCalEnergy();            
-            int det2 = leafToClover[chan2->GetChanID().GetLocation()];
+            int det2 = CloverOf(chan2->GetChanID().GetLocation());
             double gTime2 = chan2->GetCorrectedTime();
 
             if (gEnergy2 < gammaThreshold_) 
@@ -752,7 +796,7 @@ bool GeProcessor::Process(RawEvent &event) {
 
             plot(D_ADD_ENERGY, gEnergy);
             plot(D_ADD_ENERGY_CLOVERX + det, gEnergy);
-            granploty(DD_ADD_ENERGY__TIMEX, gEnergy, decayTime, timeResolution);
+            granploty(DD_ADD_ENERGY__TIMEX, gEnergy, decayTime);
             if (gMulti == 1)
                 plot(multi::D_ADD_ENERGY, gEnergy);
 
@@ -770,7 +814,7 @@ bool GeProcessor::Process(RawEvent &event) {
                     if (gMulti == 1)
                         plot(multi::betaGated::D_ADD_ENERGY_PROMPT, gEnergy);
                     granploty(betaGated::DD_ADD_ENERGY__TIMEX, gEnergy,
-                            decayTime, timeResolution);
+                            decayTime);
                 }
             }
 
@@ -817,24 +861,6 @@ void GeProcessor::DeclareHistogramGranY(int dammId, int xsize, int ysize,
 					const char *title, int halfWordsPerChan,
 					const vector<float> &granularity, const char *units)
 {
-    stringstream fullTitle;
-
-    for (unsigned int i=0; i < granularity.size(); i++) {	 
-        //? translate scientific units to engineering units 
-        fullTitle << title << " (" << granularity[i] << " " << units << "/bin)";
-        histo.DeclareHistogram2D(dammId + i, xsize, ysize,
-                                 fullTitle.str().c_str(),
-                                 halfWordsPerChan, 1, 1);
-        fullTitle.str("");
-    }
-} 
-
-/**
- * Plot to a granularity spectrum
- */
-void GeProcessor::granploty(int dammId, double x, double y, const vector<float> &granularity)
-{
-    for (unsigned int i=0; i < granularity.size(); i++) {
-        plot(dammId + i, x, y / granularity[i]);
-    }
+    histo.DeclareGranularY(dammId, xsize, ysize, title, halfWordsPerChan,
+                           granularity, units);
 }
@@ -1,5 +1,6 @@
 #include "pugixml.hpp"
 
+#include "Configuration.hpp"
 #include "Exceptions.hpp"
 #include "Globals.hpp"
 #include "Messenger.hpp"
@@ -15,26 +16,22 @@ Globals::Globals() {
     hasReject_ = false;
     revision_ = "None";
     numTraces_  = 16;
+    eventCacheFile_ = "";
+    eventCacheMode_ = "None";
+    eventCacheTraces_ = false;
+    traceThreads_ = 1;
 
     try {
-        pugi::xml_document doc;
-        pugi::xml_parse_result result = doc.load_file("Config.xml");
-
         std::stringstream ss;
-        if (!result) {
-            ss << "Globals : error parsing file " << "Config.xml";
-            ss << " : " << result.description();
-            throw GeneralException(ss.str());
-        }
+        Configuration* config = Configuration::get();
 
         Messenger m;
-        pugi::xml_node description =
-            doc.child("Configuration").child("Description");
+        pugi::xml_node description = config->section("Description");
         std::string desc_text = description.text().get();
         m.detail("Experiment: " + desc_text);
 
         m.start("Loading global parameters");
-        pugi::xml_node global = doc.child("Configuration").child("Global");
+        pugi::xml_node global = config->section("Global");
         for (pugi::xml_node_iterator it = global.begin();
                                     it != global.end(); ++it) {
             if (std::string(it->name()).compare("Revision") == 0) {
@@ -98,6 +95,31 @@ Globals::Globals() {
 
                 numTraces_ =  it->attribute("value").as_uint();
 
+            } else if (std::string(it->name()).compare("EventCache") == 0) {
+
+                eventCacheFile_ = it->attribute("file").as_string();
+                eventCacheMode_ = it->attribute("mode").as_string("write");
+                eventCacheTraces_ = it->attribute("traces").as_bool(false);
+                if (eventCacheMode_ != "write" &&
+                    eventCacheMode_ != "replay") {
+                    throw GeneralException("Globals: unknown event cache"
+                                           " mode " + eventCacheMode_);
+                }
+                if (eventCacheFile_ == "") {
+                    throw GeneralException("Globals: missing event cache"
+                                           " file name");
+                }
+                ss << "Event cache: " << eventCacheFile_
+                   << " mode: " << eventCacheMode_;
+                m.detail(ss.str());
+                ss.str("");
+
+            } else if (std::string(it->name()).compare("TraceThreads") == 0) {
+
+                traceThreads_ = it->attribute("value").as_uint(1);
+                if (traceThreads_ < 1)
+                    traceThreads_ = 1;
+
             } else {
 
                 ss << "Unknown global parameter " << it->name();
@@ -121,7 +143,7 @@ Globals::Globals() {
         numTraces_ = power2;
 
         m.detail("Loading rejection regions");
-        pugi::xml_node reject = doc.child("Configuration").child("Reject");
+        pugi::xml_node reject = config->section("Reject");
         for (pugi::xml_node time = reject.child("Time"); time;
             time = time.next_sibling("Time")) {
             int start = time.attribute("start").as_int(-1);
@@ -7,6 +7,7 @@
 #include <limits>
 
 #include "DammPlotIds.hpp"
+#include "MtcCycle.hpp"
 #include "RawEvent.hpp"
 #include "ChanEvent.hpp"
 #include "Hen3Processor.hpp"
@@ -76,6 +77,22 @@ EventData Hen3Processor::BestBetaForNeutron(double nTime) {
         return EventData(-1);
 }
 
+unsigned Hen3Processor::NeutronPlace(int location) {
+    if (location >= 0 && (unsigned)location < neutronPlaces_.size() &&
+        neutronPlaces_[location] >= 0)
+        return neutronPlaces_[location];
+
+    stringstream neutron;
+    neutron << "Neutron_" << location;
+    unsigned handle = TreeCorrelator::get()->handle(neutron.str());
+    if (location >= 0) {
+        if ((unsigned)location >= neutronPlaces_.size())
+            neutronPlaces_.resize(location + 1, -1);
+        neutronPlaces_[location] = handle;
+    }
+    return handle;
+}
+
 void Hen3Processor::DeclarePlots(void)
 {
     DeclareHistogram1D(D_MULT_HEN3, S4, "3Hen event multiplicity");
@@ -122,9 +139,7 @@ bool Hen3Processor::PreProcess(RawEvent &event)
             int location = (*it)->GetChanID().GetLocation();
 
             EventData data(time, energy, location, true);
-            stringstream neutron;
-            neutron << "Neutron_" << location;
-            TreeCorrelator::get()->place(neutron.str())->activate(data);
+            TreeCorrelator::get()->place(NeutronPlace(location))->activate(data);
     }
 
     return true;
@@ -144,9 +159,9 @@ bool Hen3Processor::Process(RawEvent &event)
 
     double clockInSeconds = Globals::get()->clockInSeconds();
     /** Place Cycle is activated by BeamOn event and deactivated by TapeMove*/
-    bool tapeMove = !(TreeCorrelator::get()->place("Cycle")->status());
+    bool tapeMove = !(MtcCycle::get()->IsInCycle());
     /** Cycle time is measured from the begining of the last BeamON event */
-    double cycleTime = TreeCorrelator::get()->place("Cycle")->last().time;
+    double cycleTime = MtcCycle::get()->CycleTime();
 
     if (tapeMove) {
         for (vector<ChanEvent*>::const_iterator it = 
@@ -3,10 +3,12 @@
  * implementation for scintillator processor
  */
 
+#include <sstream>
 #include <vector>
 
 #include <cmath>
 
+#include "ColumnFile.hpp"
 #include "DammPlotIds.hpp"
 #include "Globals.hpp"
 #include "RawEvent.hpp"
@@ -45,10 +47,10 @@ IonChamberProcessor::IonChamberProcessor() :
 {
     associatedTypes.insert("ion_chamber"); // associate with the scint type
 
+    // since there is some dead time only take times greater than a
+    //  specific safe value (thanks to memorylessness of distribution)
     for (size_t i=0; i < noDets; i++) {
-      lastTime[i] = -1;
-      //     timeDiffs.clear();
-      timeDiffs[i].clear();
+      rates[i] = RateEstimator(timesToKeep, minTime);
     }
 }
 
@@ -120,7 +122,7 @@ bool IonChamberProcessor::Process(RawEvent &event)
 	 it != icEvents.end(); it++) {
       size_t loc = (*it)->GetChanID().GetLocation();
       double ecal = (*it)->GetCalEnergy();
-      if (loc > noDets) {
+      if (loc >= noDets) {
 	// unexpected location
 	continue;
       }
@@ -142,35 +144,14 @@ bool IonChamberProcessor::Process(RawEvent &event)
 	}
 
       }
-      if (lastTime[loc] != -1) {
-	double dtime = (*it)->GetTime() - lastTime[loc];
-	plot(D_DTIME_DETX + loc, dtime / 10);
-	
-	if (dtime > minTime)
-	  timeDiffs[loc].push_back( dtime );
-	if (timeDiffs[loc].size() >= timesToKeep) {
-	  timeDiffs[loc].pop_front();
-
-	  // now calculate the rate as the inverse of the mean
-	  //  of the assumed Poissonic distribution
-	  // since there is some dead time only take times greater than a
-	  //  specific safe value (thanks to memorylessness of distribution)
-	  
-	  double sum = 0.;
-	  int count = 0;
-
-	  for (deque<double>::const_iterator dit = timeDiffs[loc].begin();
-	       dit < timeDiffs[loc].end(); dit++) {
-	    sum += *dit - minTime;
-	    count++;
-	  }
-	  double mean = double(sum / count);
-	  plot(D_RATE_DETX + loc,
-          (double)(1 / mean / Globals::get()->clockInSeconds()));
-	}
-
-      } 
-      lastTime[loc] = (*it)->GetTime();      
+      // the rate is the inverse of the mean of the assumed
+      //  Poissonic distribution of the times between hits
+      if (rates[loc].Add((*it)->GetTime()) && rates[loc].Full()) {
+	plot(D_RATE_DETX + loc,
+	     rates[loc].Rate() / Globals::get()->clockInSeconds());
+      }
+      if (rates[loc].LastInterval() == rates[loc].LastInterval())
+	plot(D_DTIME_DETX + loc, rates[loc].LastInterval() / 10);
     }
     EndProcess(); // update the processing time
     return true;
@@ -184,6 +165,25 @@ void IonChamberProcessor::Data::Clear(void)
   mult = 0;
 }
 
+bool IonChamberProcessor::AddColumns(ColumnWriter *writer)
+{
+  for (size_t i=0; i < noDets; i++) {
+    stringstream raw, cal;
+    raw << name << "_raw" << i;
+    cal << name << "_cal" << i;
+    writer->AddColumn(raw.str(), &data.raw[i]);
+    writer->AddColumn(cal.str(), &data.cal[i]);
+  }
+  writer->AddColumn(name + "_mult", &data.mult);
+  return true;
+}
+
+void IonChamberProcessor::FillColumns(void)
+{
+  if (!HasEvent())
+    data.Clear();
+}
+
 #ifdef useroot
 bool IonChamberProcessor::AddBranch(TTree *tree)
 {
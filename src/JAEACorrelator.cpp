@@ -138,7 +138,6 @@ bool JAEACorrelator::flush_chain(int x, int y, Plots& histo,bool hasVETO,bool ha
     double alphaE[6]={0};
     double alphaE2[6]={0};
     double alphaTime[6]={0};
-    double dt[6],dt2[6],dt12[6];
     double BeamE=0, BeamTime=0;
     double mwpcTime = 0;
     static int ctr=0, ctra=0;
@@ -179,107 +178,26 @@ bool JAEACorrelator::flush_chain(int x, int y, Plots& histo,bool hasVETO,bool ha
 	
 			if(BeamTime>0 && alphaTime[1]>0){
 				//cout << "Timing "<< BeamTime << " " << alphaTime[1] << " " << dt << endl;
-				const unsigned int NumGranularities = 8;
-				for (unsigned int i = 0; i < NumGranularities; i++) {
-					const double timeResolution[NumGranularities] = 
-						{10e-9, 100e-9, 400e-9, 1e-6, 100e-6, 1e-3, 10e-3, 100e-3};
-	    
-	    
-					//100000000 is temporary value
-					dt[i]=100000000*(alphaTime[1]-BeamTime)*(Globals::get()->clockInSeconds()/timeResolution[i]);
-
-					/* From below, test different gates on ion energies
-					 * gate 1(center): (1700, 1800)*5
-					 * gate 2(left): (1250, 1350)*5
-					 * gate3(right): (2150, 2250)*5
-					 * by Yongchi Xiao; 08/22/2016
-					 */
-					histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX+i,2*alphaE[1],int(dt[i])); // 750-759
-	    
-					/*
-					  if(i == 4
-					  && int(dt[i]) >= 1 && int(dt[i]) <= 6
-					  && alphaE[1] > 100
-					  && alphaE2[1] > 100
-					  )
-					  {
-					  histo.Plot(8, 2*alphaE[1], x); // 708, front
-					  histo.Plot(9, 2*alphaE2[1], y); // 709, back
-					  } // by Yongchi Xiao; 10/22/2015
-					*/
-	    
-					if(BeamE > 1700*5 && BeamE < 1800*5) { // gate 1
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_VETO+i, 2*alphaE[1], int(dt[i]) );
-					}
-					if(BeamE > 1250*5 && BeamE < 1350*5) { // gate 2
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_NOVETO+i, 2*alphaE[1], int(dt[i]) );
-                    }
-					if(BeamE > 2150*5 && BeamE < 2250*5) { // gate 3
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_NAI+i, 2*alphaE[1], int(dt[i]) );
-                    }
-
-					/*
-					if(hasVETO){
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_VETO+i,2*alphaE[1],int(dt[i]));
-					}
-					if(!hasVETO){
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_NOVETO+i,2*alphaE[1],int(dt[i]));
-					}
-					if(hasNaI){
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_NAI+i,2*alphaE[1],int(dt[i]));
-					}
-					if(!hasNaI){
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_NONAI+i,2*alphaE[1],int(dt[i]));
-					}
-					if(hasPin){
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_PIN+i,2*alphaE[1],int(dt[i]));
-					}
-					if(!hasPin){
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_NOPIN+i,2*alphaE[1],int(dt[i]));
-					}
-					*/
-	    
-
-
-
-
-					if(i==3){
-						// Cs condition
-						if(int(dt[i])<50){
-							//cout << "Cs: " << alphaE[1] << " " << y << endl; 
-							histo.Plot(dammIds::dssd4jaea::DD_IMPLANT_CSGATE,alphaE[1],y);
-						}
-						// I condition
-						if(int(dt[i])>50 && int(dt[i])<200){
-							//cout << "I: "<<alphaE[1] << " " << y << endl; 
-							histo.Plot(dammIds::dssd4jaea::DD_IMPLANT_IGATE,alphaE[1],y);
-						}
-
-	      
-					}
-	    
-					//cout << "check " << BeamE << " " << int(dt[i]) << endl;
-					if(alphaTime[2]>0){
-						dt2[i]=100000000*(alphaTime[2]-BeamTime)*(Globals::get()->clockInSeconds()/timeResolution[i]);
-						dt12[i]=100000000*(alphaTime[2]-alphaTime[1])*(Globals::get()->clockInSeconds()/timeResolution[i]);
-						//	      histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX+i,2*alphaE[1],int(dt[i]));
-						//cout << "Decay E1: "<< alphaE[1] << " Decay E2: " << alphaE[2]  << " Time " << int(dt12[i]) << endl;
-	      
-						histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY_TIME_GRANX_SECOND+i,2*alphaE[1],int(dt12[i]));	     
-	      
-
-	      
-
-	      
-
-
-	      
-					}
-
-	    
-
+				/* The decay energy vs. decay time histograms at several
+				 * time resolutions (750-757 and the energy gated
+				 * 850-877) are disabled in
+				 * Dssd4JAEAProcessor::DeclarePlots, enable them there
+				 * and fill them here with Plots::PlotGranularY */
+				//100000000 is temporary value
+				double dt1 = 100000000 * (alphaTime[1] - BeamTime) *
+					Globals::get()->clockInSeconds();
+
+				// 1 us/bin
+				int dt1us = int(dt1 / 1e-6);
+				// Cs condition
+				if(dt1us<50){
+					histo.Plot(dammIds::dssd4jaea::DD_IMPLANT_CSGATE,alphaE[1],y);
 				}
-	  
+				// I condition
+				if(dt1us>50 && dt1us<200){
+					histo.Plot(dammIds::dssd4jaea::DD_IMPLANT_IGATE,alphaE[1],y);
+				}
+
 				// front 788 1st decay and 2nd decay
 				if(alphaE[1]>0 && alphaE[2]>0){
 					histo.Plot(dammIds::dssd4jaea::DD_ENERGY_DECAY12,alphaE[1],alphaE[2]);
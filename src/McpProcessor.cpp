@@ -3,10 +3,13 @@
  *   and calculates a 2D position based on the readout
  * SNL 2-2-08, Modified DTM 9-09
  */
+#include <sstream>
+
 #ifdef useroot
 #include <TTree.h>
 #endif
 
+#include "ColumnFile.hpp"
 #include "DammPlotIds.hpp"
 #include "McpProcessor.hpp"
 #include "RawEvent.hpp"
@@ -171,6 +174,25 @@ bool McpProcessor::Process(RawEvent &event)
 	//cout << "mult: " << data.mult << endl;// by Yongchi Xiao
 }
 
+bool McpProcessor::AddColumns(ColumnWriter *writer)
+{
+	for (size_t i=0; i < nPos; i++) {
+		stringstream raw;
+		raw << name << "_raw" << i;
+		writer->AddColumn(raw.str(), &data.raw[i]);
+	}
+	writer->AddColumn(name + "_xpos", &data.xpos);
+	writer->AddColumn(name + "_ypos", &data.ypos);
+	writer->AddColumn(name + "_mult", &data.mult);
+	return true;
+}
+
+void McpProcessor::FillColumns(void)
+{
+	if (!HasEvent())
+		data.Clear();
+}
+
 #ifdef useroot
 bool McpProcessor::AddBranch(TTree *tree)
 {
@@ -0,0 +1,116 @@
+/** \file MtcCycle.cpp
+ *
+ * State of the measurement cycle driven by the MTC and beam signals
+ */
+
+#include "ChanIdentifier.hpp"
+#include "Globals.hpp"
+#include "MtcCycle.hpp"
+#include "TreeCorrelator.hpp"
+
+using namespace std;
+
+MtcCycle* MtcCycle::instance = NULL;
+
+/** Instance is created upon first call */
+MtcCycle* MtcCycle::get() {
+    if (!instance) {
+        instance = new MtcCycle();
+    }
+    return instance;
+}
+
+MtcCycle::MtcCycle() {
+    beamPlace_ = PlaceHandle("Beam");
+    cyclePlace_ = PlaceHandle("Cycle");
+    tapeMovePlace_ = PlaceHandle("TapeMove");
+
+    TreeCorrelator* tree = TreeCorrelator::get();
+    beamOn_ = (beamPlace_ >= 0 && tree->place(beamPlace_)->status());
+    inCycle_ = (cyclePlace_ >= 0 && tree->place(cyclePlace_)->status());
+    tapeMoving_ = (tapeMovePlace_ >= 0 &&
+                   tree->place(tapeMovePlace_)->status());
+    beamTime_ = -1;
+    if (beamPlace_ >= 0)
+        beamTime_ = tree->place(beamPlace_)->last().time;
+    cycleTime_ = -1;
+    if (cyclePlace_ >= 0)
+        cycleTime_ = tree->place(cyclePlace_)->last().time;
+    cycleNumber_ = 0;
+    for (int i = 0; i < NUM_SIGNALS; ++i)
+        lastHit_[i] = -1;
+}
+
+int MtcCycle::PlaceHandle(const string& name) {
+    TreeCorrelator* tree = TreeCorrelator::get();
+    if (tree->places_.count(name) == 0)
+        return -1;
+    return tree->handle(name);
+}
+
+void MtcCycle::SetPlace(int handle, bool on, double time) {
+    if (handle < 0)
+        return;
+    if (on)
+        TreeCorrelator::get()->place((unsigned)handle)->activate(time);
+    else
+        TreeCorrelator::get()->place((unsigned)handle)->deactivate(time);
+}
+
+MtcCycle::Signal MtcCycle::SignalOf(const Identifier& id) {
+    if (id.GetType() != "mtc" || id.GetLocation() != 0)
+        return NONE;
+    const string& subtype = id.GetSubtype();
+    if (subtype == "start")
+        return MOVE_START;
+    if (subtype == "stop")
+        return MOVE_STOP;
+    if (subtype == "beam_start")
+        return BEAM_START;
+    if (subtype == "beam_stop")
+        return BEAM_STOP;
+    return NONE;
+}
+
+void MtcCycle::Transition(Signal signal, double time) {
+    switch (signal) {
+        case MOVE_START:
+            tapeMoving_ = true;
+            inCycle_ = false;
+            cycleTime_ = time;
+            SetPlace(tapeMovePlace_, true, time);
+            SetPlace(cyclePlace_, false, time);
+            break;
+        case MOVE_STOP:
+            tapeMoving_ = false;
+            SetPlace(tapeMovePlace_, false, time);
+            break;
+        case BEAM_START:
+            SetBeam(true, time);
+            if (!inCycle_)
+                ++cycleNumber_;
+            inCycle_ = true;
+            cycleTime_ = time;
+            SetPlace(cyclePlace_, true, time);
+            break;
+        case BEAM_STOP:
+            SetBeam(false, time);
+            break;
+        default:
+            break;
+    }
+}
+
+void MtcCycle::SetBeam(bool on, double time) {
+    beamOn_ = on;
+    beamTime_ = time;
+    SetPlace(beamPlace_, on, time);
+}
+
+double MtcCycle::TimeInCycle(double time) const {
+    return (time - cycleTime_) * Globals::get()->clockInSeconds();
+}
+
+double MtcCycle::TimeSinceBeam(double time) const {
+    return (time - beamTime_) * Globals::get()->clockInSeconds();
+}
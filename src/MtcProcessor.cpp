@@ -13,8 +13,10 @@
 #include <cmath>
 
 #include "DammPlotIds.hpp"
+#include "DetectorLibrary.hpp"
 #include "Globals.hpp"
 #include "RawEvent.hpp"
+#include "MtcCycle.hpp"
 #include "MtcProcessor.hpp"
 
 using namespace std;
@@ -48,6 +50,21 @@ MtcProcessor::MtcProcessor(bool double_stop, bool double_start)
     double_start_ = double_start;
 }
 
+bool MtcProcessor::Init(RawEvent &event)
+{
+    if (!EventProcessor::Init(event))
+        return false;
+
+    // resolve the signal of each channel once
+    DetectorLibrary* modChan = DetectorLibrary::get();
+    signals_.assign(modChan->size(), MtcCycle::NONE);
+    for (DetectorLibrary::size_type i = 0; i < modChan->size(); ++i) {
+        if (modChan->HasValue(i))
+            signals_[i] = MtcCycle::SignalOf(modChan->at(i));
+    }
+    return true;
+}
+
 void MtcProcessor::DeclarePlots(void)
 {
     using namespace dammIds::mtc;
@@ -79,13 +96,17 @@ bool MtcProcessor::PreProcess(RawEvent &event)
     static const vector<ChanEvent*> &mtcEvents = 
         event.GetSummary("mtc", true)->GetList();
 
+    MtcCycle* cycle = MtcCycle::get();
+
     for (vector<ChanEvent*>::const_iterator it = mtcEvents.begin();
 	 it != mtcEvents.end(); it++) {
-        string subtype = (*it)->GetChanID().GetSubtype();
+        unsigned id = (*it)->GetID();
+        if (id >= signals_.size() || signals_[id] == MtcCycle::NONE)
+            continue;
+        MtcCycle::Signal signal = MtcCycle::Signal(signals_[id]);
         double time   = (*it)->GetTime();	
         // Time of the first event
         static double t0 = time;
-        string place = (*it)->GetChanID().GetPlaceName();
 
         // for 2d plot of events 100ms / bin
         const double eventsResolution = 100e-3 / clockInSeconds;
@@ -95,69 +116,62 @@ bool MtcProcessor::PreProcess(RawEvent &event)
         const unsigned BEAM_STOP = 3;
         double time_x = int((time - t0) / eventsResolution);
 
-        if(place == "mtc_start_0") {
+        // time since the previous signal of the same kind
+        double dt_signal = time - cycle->Hit(signal, time);
 
-            double dt_start = time - 
-                     TreeCorrelator::get()->place(place)->secondlast().time;
-            TreeCorrelator::get()->place("TapeMove")->activate(time);
-            TreeCorrelator::get()->place("Cycle")->deactivate(time);
+        switch (signal) {
+        case MtcCycle::MOVE_START: {
+            cycle->Transition(signal, time);
 
-            plot(D_TDIFF_MOVE_START, dt_start / mtcPlotResolution);
+            plot(D_TDIFF_MOVE_START, dt_signal / mtcPlotResolution);
             plot(D_COUNTER, MOVE_START_BIN);
             plot(DD_TIME__DET_MTCEVENTS, time_x, MTC_START);
+            break;
+        }
+        case MtcCycle::MOVE_STOP: {
+            double dt_move = time - cycle->LastHit(MtcCycle::MOVE_START);
+            cycle->Transition(signal, time);
 
-        } else if (place == "mtc_stop_0") {
-
-            double dt_stop = time - 
-                     TreeCorrelator::get()->place(place)->secondlast().time;
-            double dt_move = time - 
-                     TreeCorrelator::get()->place("mtc_start_0")->last().time;
-            TreeCorrelator::get()->place("TapeMove")->deactivate(time);
-
-            plot(D_TDIFF_MOVE_STOP, dt_stop / mtcPlotResolution);
+            plot(D_TDIFF_MOVE_STOP, dt_signal / mtcPlotResolution);
             plot(D_MOVETIME, dt_move / mtcPlotResolution);
             plot(D_COUNTER, MOVE_STOP_BIN);
             plot(DD_TIME__DET_MTCEVENTS, time_x, MTC_STOP);
-
-        } else if (place == "mtc_beam_start_0") {
-
-            double dt_start = time -
-                      TreeCorrelator::get()->place(place)->secondlast().time;
+            break;
+        }
+        case MtcCycle::BEAM_START: {
             //Remove double starts
             if (double_start_) {
                 double dt_stop = abs(time - 
-                  TreeCorrelator::get()->place("mtc_beam_stop_0")->last().time);
-                if (abs(dt_start * clockInSeconds) < doubleTimeLimit_ ||
+                                     cycle->LastHit(MtcCycle::BEAM_STOP));
+                if (abs(dt_signal * clockInSeconds) < doubleTimeLimit_ ||
                     abs(dt_stop * clockInSeconds) < doubleTimeLimit_)
                     continue;
             }
-            TreeCorrelator::get()->place("Beam")->activate(time);
-            TreeCorrelator::get()->place("Cycle")->activate(time);
+            cycle->Transition(signal, time);
 
-            plot(D_TDIFF_BEAM_START, dt_start / mtcPlotResolution);
+            plot(D_TDIFF_BEAM_START, dt_signal / mtcPlotResolution);
             plot(D_COUNTER, BEAM_START_BIN);
             plot(DD_TIME__DET_MTCEVENTS, time_x, BEAM_START);
-
-        } else if (place == "mtc_beam_stop_0") {
-
-            double dt_stop = time - 
-                TreeCorrelator::get()->place(place)->secondlast().time;
-            double dt_beam = time - 
-                 TreeCorrelator::get()->place("mtc_beam_start_0")->last().time;
+            break;
+        }
+        case MtcCycle::BEAM_STOP: {
+            double dt_beam = time - cycle->LastHit(MtcCycle::BEAM_START);
             //Remove double stops
             if (double_stop_) {
-                if (abs(dt_stop * clockInSeconds) < doubleTimeLimit_ ||
+                if (abs(dt_signal * clockInSeconds) < doubleTimeLimit_ ||
                     abs(dt_beam * clockInSeconds) < doubleTimeLimit_)
                     continue;
             }
+            cycle->Transition(signal, time);
 
-            TreeCorrelator::get()->place("Beam")->deactivate(time);
-
-            plot(D_TDIFF_BEAM_STOP, dt_stop / mtcPlotResolution);
+            plot(D_TDIFF_BEAM_STOP, dt_signal / mtcPlotResolution);
             plot(D_BEAMTIME, dt_beam / mtcPlotResolution);
             plot(D_COUNTER, BEAM_STOP_BIN);
             plot(DD_TIME__DET_MTCEVENTS, time_x, BEAM_STOP);
-
+            break;
+        }
+        default:
+            break;
         }
     }
     return true;
@@ -2,6 +2,8 @@
 #include <time.h>
 #include "pugixml.hpp"
 
+#include "AsyncWriter.hpp"
+#include "Configuration.hpp"
 #include "Messenger.hpp"
 #include "Notebook.hpp"
 #include "Exceptions.hpp"
@@ -17,17 +19,7 @@ Notebook* Notebook::get() {
 }
 
 Notebook::Notebook() {
-    pugi::xml_document doc;
-
-    pugi::xml_parse_result result = doc.load_file("Config.xml");
-    if (!result) {
-        std::stringstream ss;
-        ss << "Notebook: error parsing file Config.xml";
-        ss << " : " << result.description();
-        throw IOException(ss.str());
-    }
-
-    pugi::xml_node note = doc.child("Configuration").child("Notebook");
+    pugi::xml_node note = Configuration::get()->section("Notebook");
 
     file_name_ = std::string(note.attribute("file").as_string());
     mode_ = std::string(note.attribute("mode").as_string("a"));
@@ -67,15 +59,9 @@ const std::string Notebook::currentDateTime() const {
     return buf;
 }
 
+/** The note is appended to the file by the AsyncWriter thread,
+ * errors are reported by the following calls */
 void Notebook::report(std::string note) {
-    std::ofstream note_file;
-    note_file.open(file_name_.c_str(), std::ios::out | std::ios::app);
-    if (!note_file.good()) {
-        std::stringstream ss;
-        ss << "Notebook: error opening output file";
-        ss << " : " << file_name_;
-        throw IOException(ss.str());
-    }
-    note_file << note << std::endl;
-    note_file.close();
+    note += '\n';
+    AsyncWriter::get()->Write(file_name_, note);
 }
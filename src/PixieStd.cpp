@@ -45,15 +45,21 @@
 
 #include "pixie16app_defs.h"
 
+#include "AsyncWriter.hpp"
 #include "DetectorDriver.hpp"
 #include "DetectorLibrary.hpp"
 #include "DetectorSummary.hpp"
+#include "ColumnFile.hpp"
+#include "EventCache.hpp"
+#include "EventTap.hpp"
 #include "ChanEvent.hpp"
 #include "RawEvent.hpp"
 #include "DammPlotIds.hpp"
 #include "Globals.hpp"
 #include "Plots.hpp"
 #include "PlotsRegister.hpp"
+#include "Skimmer.hpp"
+#include "SpillCounts.hpp"
 #include "TreeCorrelator.hpp"
 #include "Messenger.hpp"
 #include "Exceptions.hpp"
@@ -74,6 +80,49 @@ enum HistoPoints {BUFFER_START, BUFFER_END, EVENT_START = 10, EVENT_CONTINUE};
 void ScanList(vector<ChanEvent*> &eventList, RawEvent& rawev);
 void RemoveList(vector<ChanEvent*> &eventList);
 void HistoStats(unsigned int, double, double, HistoPoints);
+void FlushStats();
+void EndSpill();
+
+namespace {
+    /** Hits in the same cell (x, y) of a histogram filled in time order */
+    struct RunLength {
+        int x;
+        int y;
+        unsigned count;
+        RunLength() : x(0), y(0), count(0) {}
+    };
+
+    /** Per hit bookkeeping spectra of ScanList and HistoStats, counted
+     * during the spill and plotted with weights by FlushStats() */
+    struct SpillStats {
+        SpillCounts hits;  ///< D_HIT_SPECTRUM, cell is the id
+        SpillCounts times; ///< D_TIME + id, cell is id * SE + time bin
+        std::vector<RunLength> scalars; ///< D_SCALAR + id, x in s
+        RunLength runSecs;  ///< DD_RUNTIME_SEC
+        RunLength runMsecs; ///< DD_RUNTIME_MSEC
+    } spillStats;
+
+    /** Adds the counts of the cell, y = -1 for a 1D histogram */
+    void FlushRun(RunLength& run, int dammId) {
+        if (run.count == 0)
+            return;
+        DetectorDriver::get()->plotWeighted(dammId, run.x, run.y, run.count);
+        run.count = 0;
+    }
+
+    /** Counts the hit in the cell (x, y), plotting the counts of the
+     * previous cell when the cell changes */
+    void CountRun(RunLength& run, int dammId, int x, int y = -1) {
+        if (run.count > 0 && run.x == x && run.y == y) {
+            ++run.count;
+            return;
+        }
+        FlushRun(run, dammId);
+        run.x = x;
+        run.y = y;
+        run.count = 1;
+    }
+}
 
 #ifdef newreadout
 /**
@@ -194,7 +243,9 @@ extern "C" void hissub_(unsigned short *sbuf[],unsigned short *nhw)
                 totData[dataWords++] = 2;
                 totData[dataWords++] = 9999;
                 
-                MakeModuleData(totData, dataWords, maxWords);
+                if (MakeModuleData(totData, dataWords, maxWords) &&
+                    Skimmer::enabled())
+                    Skimmer::get()->EndSpill(totData, dataWords);
                 spillValidCount++;
                 bufInSpill = 0; dataWords = 0; lastBuf = -1;
             } else if (bufNum == 0) {
@@ -273,7 +324,9 @@ extern "C" void hissub_(unsigned short *sbuf[],unsigned short *nhw)
             spillInvalidCount++; 
         } else {
             spillValidCount++;
-            MakeModuleData(totData, dataWords, maxWords);	    
+            if (MakeModuleData(totData, dataWords, maxWords) &&
+                Skimmer::enabled())
+                Skimmer::get()->EndSpill(totData, dataWords);
         } // else the number of buffers is complete
         dataWords = 0; bufInSpill = 0; lastBuf = -1; // reset the number of buffers recorded
     } while (totWords < nhw[0] / 4);
@@ -458,8 +511,24 @@ extern "C" void hissub_(unsigned short *ibuf[],unsigned short *nhw)
         ss << "Init at " << times(&tmsBegin) << " sys time.";
         messenger.detail(ss.str());
         messenger.done();
+
+        /* In the replay mode the events stored in the event cache are
+         * processed instead of the data, all buffers are ignored */
+        if (EventCache::get()->replaying()) {
+            try {
+                EventCache::get()->Replay(rawev, EndSpill);
+            } catch (GeneralException &e) {
+                cout << "Exception caught while replaying the event cache"
+                     << " in PixieStd" << endl;
+                cout << "\t" << e.what() << endl;
+                exit(EXIT_FAILURE);
+            }
+        }
     }
     counter++;
+
+    if (EventCache::get()->replaying())
+        return;
  
     unsigned int nWords=0;  // buffer counter, reset only for new buffer
  
@@ -607,10 +676,18 @@ extern "C" void hissub_(unsigned short *ibuf[],unsigned short *nhw)
                     sort(eventList.begin(),eventList.end(),CompareTime);
                     driver->CorrelateClock(lastTimestamp, theTime);
 
+                    if (Skimmer::enabled())
+                        Skimmer::get()->Select(eventList);
+
+                    // trace analysis does not depend on the event
+                    // building, do it for the whole spill at once
+                    driver->AnalyzeTraces(eventList);
+
                     /* once the vector of pointers eventlist is sorted
                      * based on time, begin the event processing in ScanList()
                     */
                     ScanList(eventList, rawev);
+                    EndSpill();
 
                     /* once the eventlist has been scanned, remove it
                      * from memory and reset the number of events to zero
@@ -727,6 +804,13 @@ void ScanList(vector<ChanEvent*> &eventList, RawEvent& rawev)
      * this is needed for the rejection regions */
     static double firstTime = lastTime;
 
+    if (spillStats.hits.Size() == 0) {
+        spillStats.hits.Resize(modChan->size());
+        spillStats.scalars.resize(modChan->size());
+        if (Globals::get()->revision() == "A")
+            spillStats.times.Resize(modChan->size() * SE);
+    }
+
     HistoStats(id, diffTime, lastTime, BUFFER_START);
 
     //loop over the list of channels that fired in this buffer
@@ -794,12 +878,9 @@ void ScanList(vector<ChanEvent*> &eventList, RawEvent& rawev)
             rawev.Zero(usedDetectors);
             usedDetectors.clear();	    
 
-            // Now clear all places in correlator (if resetable type)
-            for (map<string, Place*>::iterator it =
-                    TreeCorrelator::get()->places_.begin();
-                it != TreeCorrelator::get()->places_.end(); ++it)
-                if ((*it).second->resetable())
-                    (*it).second->reset();
+            // Now clear places in correlator touched in this event
+            // (if resetable type)
+            TreeCorrelator::get()->resetPlaces();
 
             HistoStats(id, diffTime, currTime, EVENT_START);
         } else HistoStats(id, diffTime, currTime, EVENT_CONTINUE);
@@ -810,7 +891,13 @@ void ScanList(vector<ChanEvent*> &eventList, RawEvent& rawev)
             messenger.warning(ss.str());
             ss.str("");
         }
-        driver->plot(D_TIME + id, dtimebin);
+        // D_TIME spectra exist only for revision A, see DeclarePlots
+        if (spillStats.times.Size() > 0) {
+            if (dtimebin < (unsigned)(SE))
+                spillStats.times.Add(id * SE + dtimebin);
+            else
+                driver->plot(D_TIME + id, dtimebin);
+        }
 
         usedDetectors.insert((*modChan)[id].GetType());
         rawev.AddChan(*iEvent);
@@ -923,12 +1010,63 @@ void HistoStats(unsigned int id, double diff, double clock, HistoPoints event)
     // Exclude event type 0/1 since it will also appear as an
     // event type 11
     if ( event != BUFFER_START && event != BUFFER_END ){      
-        driver->plot(DD_RUNTIME_SEC, remainNumSecs, rowNumSecs);
-        driver->plot(DD_RUNTIME_MSEC, remainNumMsecs, rowNumMsecs);
+        CountRun(spillStats.runSecs, DD_RUNTIME_SEC,
+                 int(remainNumSecs), rowNumSecs);
+        CountRun(spillStats.runMsecs, DD_RUNTIME_MSEC,
+                 int(remainNumMsecs), rowNumMsecs);
         //fill scalar spectrum (per second) 
-        driver->plot(D_HIT_SPECTRUM, id);
-        driver->plot(D_SCALAR + id, runTimeSecs);
+        if (id < spillStats.hits.Size()) {
+            spillStats.hits.Add(id);
+            CountRun(spillStats.scalars[id], D_SCALAR + id,
+                     int(runTimeSecs));
+        } else {
+            driver->plot(D_HIT_SPECTRUM, id);
+            driver->plot(D_SCALAR + id, runTimeSecs);
+        }
+    }
+}
+
+/**
+ * Plots the counts of the per hit spectra of HistoStats() and ScanList()
+ * collected during the spill, one weighted plot per filled cell
+ */
+void FlushStats()
+{
+    DetectorDriver* driver = DetectorDriver::get();
+
+    FlushRun(spillStats.runSecs, DD_RUNTIME_SEC);
+    FlushRun(spillStats.runMsecs, DD_RUNTIME_MSEC);
+
+    const vector<unsigned>& hits = spillStats.hits.Touched();
+    for (vector<unsigned>::const_iterator it = hits.begin();
+         it != hits.end(); ++it) {
+        driver->plotWeighted(D_HIT_SPECTRUM, *it, 0, spillStats.hits[*it]);
+        FlushRun(spillStats.scalars[*it], D_SCALAR + *it);
     }
+    spillStats.hits.Clear();
+
+    const vector<unsigned>& times = spillStats.times.Touched();
+    for (vector<unsigned>::const_iterator it = times.begin();
+         it != times.end(); ++it)
+        driver->plotWeighted(D_TIME + *it / SE, *it % SE, 0,
+                             spillStats.times[*it]);
+    spillStats.times.Clear();
+}
+
+/**
+ * Writes out what was collected during the spill: the statistics spectra,
+ * the accumulated plots and the queued output. Called after each spill is
+ * scanned and at each spill boundary of the event cache replay.
+ */
+void EndSpill()
+{
+    FlushStats();
+    EventCache::get()->EndSpill();
+    ColumnWriter::FlushAll();
+    if (EventTap::enabled())
+        EventTap::get()->Flush();
+    AsyncWriter::get()->Flush();
+    PlotsRegister::get()->Flush();
 }
 
 
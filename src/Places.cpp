@@ -1,11 +1,24 @@
 #include <iostream>
 #include <sstream>
 #include <map>
+#include <algorithm>
 #include "TreeCorrelator.hpp"
 #include "Exceptions.hpp"
 
 using namespace std;
 
+vector<Place*> Place::dirty_list_;
+const EventData Place::empty_(-1);
+
+Place::~Place() {
+    if (dirty_) {
+        vector<Place*>::iterator it =
+            find(dirty_list_.begin(), dirty_list_.end(), this);
+        if (it != dirty_list_.end())
+            dirty_list_.erase(it);
+    }
+}
+
 bool Place::checkParents(Place* child) {
     bool isAllDifferent = true;
     vector<Place*>::iterator it;
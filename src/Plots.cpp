@@ -3,13 +3,16 @@
  * Implement a block declaration scheme for DAMM plots
  */
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <sstream>
 
 #include "Plots.hpp"
 #include "PlotsRegister.hpp"
 #include "Exceptions.hpp"
+#include "TimeSlices.hpp"
 
 using namespace std;
 
@@ -94,6 +97,7 @@ bool Plots::DeclareHistogram1D(int dammId, int xSize, const char* title,
     hd1d_(dammId + offset_, halfWordsPerChan, xSize, xHistLength,
           xLow, xHigh, title, strlen(title));
     titleList.insert( pair<int, string>(dammId, string(title)));
+    AddSlice(dammId, 1);
     return true;
 }
 
@@ -141,6 +145,7 @@ bool Plots::DeclareHistogram2D(int dammId, int xSize, int ySize,
     hd2d_(dammId + offset_, halfWordsPerChan, xSize, xHistLength, xLow, xHigh,
 	  ySize, yHistLength, yLow, yHigh, title, strlen(title));
     titleList.insert( pair<int, string>(dammId, string(title)));
+    AddSlice(dammId, 2);
     return true;
 }
 
@@ -165,6 +170,102 @@ bool Plots::DeclareHistogram2D(int dammId, int xSize, int ySize,
 }
 
 
+bool Plots::DeclareGranularY(int dammId, int xSize, int ySize,
+                             const char* title, int halfWordsPerChan,
+                             const vector<float> &granularity,
+                             const char* units)
+{
+    GranularY axis;
+    axis.ySize = ySize;
+    stringstream fullTitle;
+    for (unsigned i = 0; i < granularity.size(); ++i) {
+        //? translate scientific units to engineering units
+        fullTitle << title << " (" << granularity[i] << " " << units
+                  << "/bin)";
+        if (!DeclareHistogram2D(dammId + i, xSize, ySize,
+                                fullTitle.str().c_str(),
+                                halfWordsPerChan, 1, 1))
+            return false;
+        fullTitle.str("");
+        axis.granularity.push_back(make_pair(granularity[i], (int)i));
+    }
+    /** Coarsest first, so the filling stops at the first overflow */
+    sort(axis.granularity.begin(), axis.granularity.end(),
+         greater< pair<float, int> >());
+    granular_[dammId] = axis;
+    return true;
+}
+
+bool Plots::PlotGranularY(int dammId, double x, double y)
+{
+    map<int, GranularY>::const_iterator it = granular_.find(dammId);
+    if (it == granular_.end())
+        return false;
+
+    const GranularY &axis = it->second;
+    for (vector< pair<float, int> >::const_iterator g =
+            axis.granularity.begin(); g != axis.granularity.end(); ++g) {
+        int bin = int(y / g->first);
+        /** Finer granularities give even larger bins */
+        if (bin < 0 || bin >= axis.ySize)
+            break;
+        /** Through Plot, so sparse and sliced histograms are honoured */
+        Plot(dammId + g->second, x, bin);
+    }
+    return true;
+}
+
+bool Plots::PlotSymmetric(int dammId, double val1, double val2)
+{
+    map<int, SymmetricHistogram*>::iterator it = symmetric_.find(dammId);
+    if (it == symmetric_.end()) {
+        Plot(dammId, val1, val2);
+        return Plot(dammId, val2, val1);
+    }
+
+    if (!sliced_.empty() && dammId >= 0 &&
+        dammId < (int)sliced_.size() && sliced_[dammId] >= 0) {
+        TimeSlices::get()->Add(sliced_[dammId], int(val1), int(val2), 1);
+        TimeSlices::get()->Add(sliced_[dammId], int(val2), int(val1), 1);
+    }
+    it->second->Fill(val1, val2);
+    return true;
+}
+
+bool Plots::DeclareSymmetric2D(int dammId, int size, const char* title,
+                               int halfWordsPerChan, const string &mne)
+{
+    if (!DeclareHistogram2D(dammId, size, size, title, halfWordsPerChan, mne))
+        return false;
+    symmetric_[dammId] =
+        PlotsRegister::get()->AddSymmetric(dammId + offset_, size);
+    return true;
+}
+
+void Plots::AddSlice(int dammId, int dims)
+{
+    int slot = TimeSlices::get()->Slot(dammId + offset_, dims);
+    if (slot < 0)
+        return;
+    if ((int)sliced_.size() <= dammId)
+        sliced_.resize(dammId + 1, -1);
+    sliced_[dammId] = slot;
+}
+
+bool Plots::DeclareSparse2D(int dammId, int xSize, int ySize,
+                            const char* title, int halfWordsPerChan,
+                            const string &mne)
+{
+    if (!DeclareHistogram2D(dammId, xSize, ySize, title, halfWordsPerChan,
+                            mne))
+        return false;
+    if ((int)sparse_.size() <= dammId)
+        sparse_.resize(dammId + 1, NULL);
+    sparse_[dammId] =
+        PlotsRegister::get()->AddSparse(dammId + offset_, xSize, ySize);
+    return true;
+}
+
 bool Plots::Plot(int dammId, double val1, double val2, double val3, const char* name)
 {
     /*
@@ -185,6 +286,22 @@ bool Plots::Plot(int dammId, double val1, double val2, double val3, const char*
         return false;
     */
 
+    if (!sliced_.empty() && dammId >= 0 &&
+        dammId < (int)sliced_.size() && sliced_[dammId] >= 0)
+        TimeSlices::get()->Fill(sliced_[dammId], val1, val2, val3);
+
+    if (!sparse_.empty() && dammId >= 0 &&
+        dammId < (int)sparse_.size() && sparse_[dammId] != NULL) {
+        /** Same meaning of the arguments as for the DAMM calls below */
+        if (val2 == -1 && val3 == -1)
+            sparse_[dammId]->Fill(int(val1), 1);
+        else if (val3 == -1 || val3 == 0)
+            sparse_[dammId]->Fill(int(val1), int(val2));
+        else
+            sparse_[dammId]->Set(int(val1), int(val2), int(val3));
+        return true;
+    }
+
     if (val2 == -1 && val3 == -1)
         count1cc_(dammId + offset_, int(val1), 1);
     else if  (val3 == -1 || val3 == 0)
@@ -195,6 +312,22 @@ bool Plots::Plot(int dammId, double val1, double val2, double val3, const char*
     return true;
 }
 
+bool Plots::PlotWeighted(int dammId, int x, int y, int weight)
+{
+    if (!sliced_.empty() && dammId >= 0 &&
+        dammId < (int)sliced_.size() && sliced_[dammId] >= 0)
+        TimeSlices::get()->Add(sliced_[dammId], x, y, weight);
+
+    if (!sparse_.empty() && dammId >= 0 &&
+        dammId < (int)sparse_.size() && sparse_[dammId] != NULL) {
+        sparse_[dammId]->Fill(x, y, weight);
+        return true;
+    }
+
+    add2cc_(dammId + offset_, x, y, weight);
+    return true;
+}
+
 bool Plots::Plot(const std::string &mne, double val1, double val2, double val3, const char* name)
 {    
     if (!Exists(mne))
@@ -10,6 +10,8 @@
 #include "PlotsRegister.hpp"
 #include "Exceptions.hpp"
 #include "Messenger.hpp"
+#include "SparseHistogram.hpp"
+#include "SymmetricHistogram.hpp"
 
 using namespace std;
 
@@ -82,3 +84,41 @@ bool PlotsRegister::Add (int offset, int range, string name)
     m.detail(ss.str(), 1);
     return true;        
 }
+
+SymmetricHistogram* PlotsRegister::AddSymmetric(int dammId, int size)
+{
+    map<int, SymmetricHistogram*>::iterator it = symmetric_.find(dammId);
+    if (it != symmetric_.end()) {
+        stringstream ss;
+        ss << "PlotsRegister: Symmetric histogram " << dammId
+           << " is already registered.";
+        throw HistogramException(ss.str());
+    }
+    SymmetricHistogram* histogram = new SymmetricHistogram(dammId, size);
+    symmetric_.insert(make_pair(dammId, histogram));
+    return histogram;
+}
+
+SparseHistogram* PlotsRegister::AddSparse(int dammId, int xSize, int ySize)
+{
+    map<int, SparseHistogram*>::iterator it = sparse_.find(dammId);
+    if (it != sparse_.end()) {
+        stringstream ss;
+        ss << "PlotsRegister: Sparse histogram " << dammId
+           << " is already registered.";
+        throw HistogramException(ss.str());
+    }
+    SparseHistogram* histogram = new SparseHistogram(dammId, xSize, ySize);
+    sparse_.insert(make_pair(dammId, histogram));
+    return histogram;
+}
+
+void PlotsRegister::Flush()
+{
+    for (map<int, SymmetricHistogram*>::iterator it = symmetric_.begin();
+         it != symmetric_.end(); ++it)
+        it->second->Flush();
+    for (map<int, SparseHistogram*>::iterator it = sparse_.begin();
+         it != sparse_.end(); ++it)
+        it->second->Flush();
+}
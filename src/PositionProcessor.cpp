@@ -100,6 +100,8 @@ bool PositionProcessor::Init(RawEvent& rawev)
     }
     minNormQdc.resize(numLocations);
     maxNormQdc.resize(numLocations);
+    topByLocation.resize(numLocations);
+    bottomByLocation.resize(numLocations);
 
     string configFile = Globals::get()->configPath("qdc.txt");
 
@@ -263,13 +265,16 @@ bool PositionProcessor::Process(RawEvent &event) {
     static const vector<ChanEvent*> &bottomEvents =
 	event.GetSummary("ssd:bottom", true)->GetList();
 
-    vector<ChanEvent *> allEvents;
     // just add in the digisum events for now
-    allEvents.insert(allEvents.begin(), digisumEvents.begin(), digisumEvents.end());
-    allEvents.insert(allEvents.begin(), sumEvents.begin(), sumEvents.end());
+    allSums.assign(sumEvents.begin(), sumEvents.end());
+    allSums.insert(allSums.end(),
+                           digisumEvents.begin(), digisumEvents.end());
 
-    for (vector<ChanEvent*>::const_iterator it = allEvents.begin();
-	     it != allEvents.end(); ++it) {
+    IndexEdges(topEvents, topByLocation);
+    IndexEdges(bottomEvents, bottomByLocation);
+
+    for (vector<ChanEvent*>::const_iterator it = allSums.begin();
+	     it != allSums.end(); ++it) {
          ChanEvent *sumchan   = *it;
 
         int location = sumchan->GetChanID().GetLocation();
@@ -283,9 +288,10 @@ bool PositionProcessor::Process(RawEvent &event) {
             continue;
         }
 
-        const ChanEvent *top    = FindMatchingEdge(sumchan, topEvents.begin(), topEvents.end());
-        const ChanEvent *bottom = FindMatchingEdge(sumchan, bottomEvents.begin(), bottomEvents.end());
-
+        ChanEvent *top    = NULL;
+        ChanEvent *bottom = NULL;
+        int numTop    = FindMatchingEdge(sumchan, topByLocation, top);
+        int numBottom = FindMatchingEdge(sumchan, bottomByLocation, bottom);
 
         if (top == NULL || bottom == NULL) {
             using namespace dammIds::position;
@@ -304,15 +310,15 @@ bool PositionProcessor::Process(RawEvent &event) {
             continue;
         }
 
-        /* Make sure we get the same match going backwards to insure there is only one in the vector */
-        if ( FindMatchingEdge(sumchan, topEvents.rbegin(), topEvents.rend()) != top) {
+        /* Make sure there is only one matching edge */
+        if (numTop > 1) {
             using namespace dammIds::position;
             // [4] -> Multiple top
             plot(D_INFO_LOCX + location, INFO_MULTIPLE_TOP);
             plot(D_INFO_LOCX + LOC_SUM, INFO_MULTIPLE_TOP);
             continue;
         }
-        if ( FindMatchingEdge(sumchan, bottomEvents.rbegin(), bottomEvents.rend()) != bottom) {
+        if (numBottom > 1) {
             using namespace dammIds::position;
             // [3] -> Multiple bottom
             plot(D_INFO_LOCX + location, INFO_MULTIPLE_BOTTOM);
@@ -341,22 +347,14 @@ bool PositionProcessor::Process(RawEvent &event) {
                 plot(D_INFO_LOCX + location, INFO_MISSING_TOP_QDC);
                 plot(D_INFO_LOCX + LOC_SUM, INFO_MISSING_TOP_QDC);
                 // Recreate qdc from trace
-                if ( !top->GetTrace().empty() ) {
-                    topQdc[0] = accumulate(top->GetTrace().begin(), top->GetTrace().begin() + qdcLen[0], 0);
-                } else {
-                    topQdc[0] = 0;
-                }
+                topQdc[0] = TraceWindow(top->GetTrace(), 0, qdcLen[0]);
             }
             if (bottomQdc[0] == pixie::U_DELIMITER) {
                 // [1] -> Missing bottom QDC
                 plot(D_INFO_LOCX + location, INFO_MISSING_BOTTOM_QDC);
                 plot(D_INFO_LOCX + LOC_SUM, INFO_MISSING_BOTTOM_QDC);
                 // Recreate qdc from trace
-                if ( !bottom->GetTrace().empty() ) {
-                    bottomQdc[0] = accumulate(bottom->GetTrace().begin(), bottom->GetTrace().begin() + qdcLen[0], 0);
-                } else {
-                    bottomQdc[0] = 0;
-                }
+                bottomQdc[0] = TraceWindow(bottom->GetTrace(), 0, qdcLen[0]);
             }
             if ( topQdc[0] == 0 || bottomQdc[0] == 0 ) {
                 continue;
@@ -370,8 +368,7 @@ bool PositionProcessor::Process(RawEvent &event) {
         for (int i = 1; i < numQdcs; ++i) {		
             if (top->GetQdcValue(i) == pixie::U_DELIMITER) {
                 // Recreate qdc from trace
-                topQdc[i] = accumulate(top->GetTrace().begin() + qdcPos[i-1],
-                top->GetTrace().begin() + qdcPos[i], 0);
+                topQdc[i] = TraceWindow(top->GetTrace(), qdcPos[i-1], qdcPos[i]);
             } else {
                 topQdc[i] = top->GetQdcValue(i);
             }
@@ -382,8 +379,7 @@ bool PositionProcessor::Process(RawEvent &event) {
             
             if (bottom->GetQdcValue(i) == pixie::U_DELIMITER) {
                 // Recreate qdc from trace
-                bottomQdc[i] = accumulate(bottom->GetTrace().begin() + qdcPos[i-1],
-                                          bottom->GetTrace().begin() + qdcPos[i], 0);
+                bottomQdc[i] = TraceWindow(bottom->GetTrace(), qdcPos[i-1], qdcPos[i]);
             } else {
                 bottomQdc[i] = bottom->GetQdcValue(i);
             }
@@ -447,28 +443,56 @@ bool PositionProcessor::Process(RawEvent &event) {
     return true;
 }
 
-ChanEvent* PositionProcessor::FindMatchingEdge(ChanEvent *match,
-					  vector<ChanEvent*>::const_iterator begin,
-					  vector<ChanEvent*>::const_iterator end) const
+/**
+ * Sorts the edge hits of the event by location in one pass
+ */
+void PositionProcessor::IndexEdges(const vector<ChanEvent*> &edges,
+                                   vector< vector<ChanEvent*> > &byLocation) const
 {
-    for (;begin < end; ++begin) {
-        if ( (*begin)->GetChanID().GetLocation() == match->GetChanID().GetLocation() &&
-            abs( (*begin)->GetTime() - match->GetTime() ) < matchingTimeCut ) {
-            return *begin;
-        }
+    for (vector< vector<ChanEvent*> >::iterator it = byLocation.begin();
+         it != byLocation.end(); ++it)
+        it->clear();
+
+    for (vector<ChanEvent*>::const_iterator it = edges.begin();
+         it != edges.end(); ++it) {
+        unsigned int location = (*it)->GetChanID().GetLocation();
+        if (location < byLocation.size())
+            byLocation[location].push_back(*it);
     }
-    return NULL;
 }
 
-ChanEvent* PositionProcessor::FindMatchingEdge(ChanEvent *match,
-					  vector<ChanEvent*>::const_reverse_iterator begin,
-					  vector<ChanEvent*>::const_reverse_iterator end) const
+/**
+ * Looks for the edges at the location of the sum within the matching
+ *   time cut. Returns the number of matches found (counting stops at 2),
+ *   edge is set to the first one.
+ */
+int PositionProcessor::FindMatchingEdge(const ChanEvent *match,
+                                        const vector< vector<ChanEvent*> > &byLocation,
+                                        ChanEvent *&edge) const
 {
-    for (;begin < end; ++begin) {
-        if ( (*begin)->GetChanID().GetLocation() == match->GetChanID().GetLocation() &&
-            abs( (*begin)->GetTime() - match->GetTime() ) < matchingTimeCut ) {
-            return *begin;
+    unsigned int location = match->GetChanID().GetLocation();
+    if (location >= byLocation.size())
+        return 0;
+
+    int numMatches = 0;
+    const vector<ChanEvent*> &edges = byLocation[location];
+    for (vector<ChanEvent*>::const_iterator it = edges.begin();
+         it != edges.end() && numMatches < 2; ++it) {
+        if ( abs( (*it)->GetTime() - match->GetTime() ) < matchingTimeCut ) {
+            if (numMatches == 0)
+                edge = *it;
+            ++numMatches;
         }
     }
-    return NULL;
+    return numMatches;
+}
+
+float PositionProcessor::TraceWindow(const Trace &trace,
+                                     unsigned int lo, unsigned int hi)
+{
+    if (hi > trace.size())
+        hi = trace.size();
+    if (lo > hi)
+        lo = hi;
+    return trace.WindowSum(lo, hi);
 }
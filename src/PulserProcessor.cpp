@@ -120,14 +120,14 @@ void PulserProcessor::AnalyzeData(void)
     unsigned int cutVal = 15;
     if((*itStart).second.maxpos == 41)
     if((*itStart).second.maxval < 2384-cutVal)
-	for(Trace::const_iterator it = (*itStart).second.trace.begin(); 
-	    it != (*itStart).second.trace.end(); it++)
-	    plot(DD_AMPMAPSTART, int(it-(*itStart).second.trace.begin()), *it);
+	for(Trace::const_iterator it = (*itStart).second.trace->begin(); 
+	    it != (*itStart).second.trace->end(); it++)
+	    plot(DD_AMPMAPSTART, int(it-(*itStart).second.trace->begin()), *it);
     
     if((*itStop).second.maxval < 2555-cutVal)
-	for(Trace::const_iterator it = (*itStart).second.trace.begin(); 
-	    it != (*itStart).second.trace.end(); it++)
-	    plot(DD_AMPMAPSTOP, int(it-(*itStart).second.trace.begin()), *it);
+	for(Trace::const_iterator it = (*itStart).second.trace->begin(); 
+	    it != (*itStart).second.trace->end(); it++)
+	    plot(DD_AMPMAPSTOP, int(it-(*itStart).second.trace->begin()), *it);
     
     double timeDiff = 
 	(*itStop).second.highResTime - (*itStart).second.highResTime;
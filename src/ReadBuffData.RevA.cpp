@@ -176,9 +176,7 @@ int ReadBuffDataA(word_t *buf, unsigned long *bufLen,
 			  halfword_t *hbuf = (halfword_t *)&buf[totalSkippedWords];
                           // Read the trace data (2-bytes per sample, i.e. 2 samples per word)
                           int numSamples = 2 * (chanLength - CHANNEL_HEAD_LENGTH);
-                          for(int k = 0; k < numSamples; k ++) {
-			      currentEvt->trace.push_back(hbuf[k]);
-                          }
+                          currentEvt->rawTrace.assign(hbuf, hbuf + numSamples);
 			  
                           totalSkippedWords += chanLength - CHANNEL_HEAD_LENGTH;
                           bufSkippedWords   += chanLength - CHANNEL_HEAD_LENGTH;
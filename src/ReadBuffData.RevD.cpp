@@ -50,7 +50,9 @@
 #include "pixie16app_defs.h"
 
 // our event structure
+#include "DetectorDriver.hpp"
 #include "DetectorLibrary.hpp"
+#include "EventTap.hpp"
 #include "Globals.hpp"
 #include "ChanEvent.hpp"
 #include "Trace.hpp"
@@ -62,8 +64,6 @@ using std::cout;
 using std::endl;
 using std::vector;
 
-extern StatsData stats;
-
 // define tst bit function from pixie16 files
 /*
 unsigned long TstBit(unsigned short bit, unsigned long value)
@@ -137,7 +137,8 @@ int ReadBuffDataDF(word_t *buf, unsigned long *bufLen,
       // make some sanity checks
       if (headerLength == stats.headerLength) {
 	// this is a manual statistics block inserted by the poll program
-	stats.DoStatisticsBlock(&buf[1], modNum);
+	if (stats.DoStatisticsBlock(&buf[1], modNum))
+	  DetectorDriver::get()->PlotStats(modNum);
 	buf += eventLength;
 	numEvents = readbuff::STATS;
 	continue;
@@ -164,8 +165,10 @@ int ReadBuffDataDF(word_t *buf, unsigned long *bufLen,
       word_t traceLength = (buf[3] & 0xFFFF0000) >> 16;
 
       if (headerLength == 8 || headerLength == 16) {
-	  // skip the onboard partial sums for now 
-	  //   trailing, leading, gap, baseline
+	  // onboard partial sums: trailing, leading, gap, baseline
+	  for (int i=0; i < currentEvt->numEsums; i++) {
+	      currentEvt->esumValue[i] = buf[4 + i];
+	  }
       }
 
       if (headerLength >= 12) {
@@ -209,23 +212,12 @@ int ReadBuffDataDF(word_t *buf, unsigned long *bufLen,
       currentEvt->eventTimeLo = lowTime;
       currentEvt->time = highTime * HIGH_MULT + lowTime;
 
-      // --- by Yongchi Xiao; 03/08/2016 --- //
-      /*
-      std::fstream outfile;
-      if( //(currentEvt->modNum == 0 && currentEvt->chanNum == 12) || (currentEvt->modNum == 4 && currentEvt->chanNum == 11) 
-	  (currentEvt->modNum == 0 && currentEvt->chanNum == 15) || (currentEvt->modNum == 4 && currentEvt->chanNum == 11)
-	 //	 	 currentEvt->time*Globals::get()->clockInSeconds() == 6230.86062112
-	  ){
-	outfile.open("readbuff.txt", std::ofstream::out | std::ofstream::app); 
-	outfile << std::setprecision(15) << Globals::get()->clockInSeconds()*currentEvt->time  << "; "
-		<< currentEvt->energy << "; "
-		<< currentEvt->chanNum << "; "
-		<< currentEvt->modNum << "; "
-		<< endl;
-      }
-      outfile.close();
-      */
-      // --- //
+      // the tap reads the channel identifier, channels missing from the
+      // map are not tapped
+      if (EventTap::enabled() &&
+          DetectorLibrary::get()->HasValue(currentEvt->modNum,
+                                           currentEvt->chanNum))
+          EventTap::get()->Raw(currentEvt);
 
 
       buf += headerLength;
@@ -234,22 +226,21 @@ int ReadBuffDataDF(word_t *buf, unsigned long *bufLen,
 	// sbuf points to the beginning of trace data
 	halfword_t *sbuf = (halfword_t *)buf;
 	
-	currentEvt->trace.reserve(traceLength);
+	// Read the trace data (2-bytes per sample, i.e. 2 samples per word),
+	// samples are kept packed and expanded only when a trace is requested
+	currentEvt->rawTrace.assign(sbuf, sbuf + traceLength);
 
 	//KM 2012-10-24 reinstating
 	if(currentEvt->saturatedBit)
 	  currentEvt->trace.SetValue("saturation", 1);
 
-	if ( lastVirtualChannel != NULL && lastVirtualChannel->trace.empty() ) {	  
-	    lastVirtualChannel->trace.assign(traceLength, 0);
-	}
-	// Read the trace data (2-bytes per sample, i.e. 2 samples per word)
-	for(unsigned int k = 0; k < traceLength; k ++) {	  
-	  currentEvt->trace.push_back(sbuf[k]);
-	  
-	  if (lastVirtualChannel != NULL) {
-	      lastVirtualChannel->trace[k] += sbuf[k];
-	  }
+	if (lastVirtualChannel != NULL) {
+	    if (lastVirtualChannel->trace.empty()) {
+		lastVirtualChannel->trace.assign(traceLength, 0);
+		lastVirtualChannel->traceExpanded = true;
+	    }
+	    for(unsigned int k = 0; k < traceLength; k ++)
+		lastVirtualChannel->trace[k] += sbuf[k];
 	}
 	buf += traceLength / 2;
       }
@@ -204,9 +204,9 @@ void ScintProcessor::LiquidAnalysis(RawEvent &event)
 
         //Graph traces for the Liquid Scintillators
         if(liquid.discrimination == 0) {
-            for(Trace::const_iterator i = liquid.trace.begin(); 
-            i != liquid.trace.end(); i++)
-                plot(DD_TRCLIQUID, int(i-liquid.trace.begin()), 
+            for(Trace::const_iterator i = liquid.trace->begin(); 
+            i != liquid.trace->end(); i++)
+                plot(DD_TRCLIQUID, int(i-liquid.trace->begin()), 
                     counter, int(*i)-liquid.aveBaseline);
             counter++;
         }
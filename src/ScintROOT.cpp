@@ -7,7 +7,8 @@ Written: S.V. Paulauskas  10 May 2011
 **************************************/
 #include <string>
 
-#include "ScintRoot.hpp"
+#include "ColumnFile.hpp"
+#include "ScintROOT.hpp"
 
 #include <TTree.h>
 
@@ -55,6 +56,18 @@ void ScintROOT::FillRoot(const TimingDataMap &detMap)
     }// end for(DataMap::
 }
 
+bool ScintROOT::AddColumns(ColumnWriter *writer)
+{
+    beta.AddColumns(writer, "Beta");
+    liquid.AddColumns(writer, "Liquid");
+    return true;
+}
+
+void ScintROOT::FillColumns(void)
+{
+    FillBranch();
+}
+
 bool ScintROOT::AddBranch(TTree *tree)
 {
     if (tree) {
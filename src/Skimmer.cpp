@@ -0,0 +1,255 @@
+/** \file Skimmer.cpp
+ *
+ * Writing of the selected spills to a reduced list mode file
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "AsyncWriter.hpp"
+#include "ChanEvent.hpp"
+#include "Configuration.hpp"
+#include "Exceptions.hpp"
+#include "Messenger.hpp"
+#include "Skimmer.hpp"
+
+using namespace std;
+using pixie::word_t;
+
+namespace {
+    /** Number of data words of a record, following type and size */
+    const unsigned recordWords = 8192;
+    /** Size of a record in the file in bytes */
+    const size_t recordBytes = (recordWords + 2) * sizeof(word_t);
+    /** Most data words of a chunk: three words of header and the
+     * delimiter following it must fit the record */
+    const unsigned chunkWords = recordWords - 4;
+    /** End of spill buffer */
+    const word_t endVsn = 9999;
+    /** Header length of the statistics blocks, see StatsData */
+    const word_t statsHeaderLength = 1;
+    /** Most modules in a crate, see MakeModuleData */
+    const word_t maxVsn = 14;
+}
+
+Skimmer* Skimmer::instance = NULL;
+bool Skimmer::enabled_ = false;
+
+/** Instance is created upon first call */
+Skimmer* Skimmer::get() {
+    if (!instance) {
+        instance = new Skimmer();
+    }
+    return instance;
+}
+
+Skimmer::Skimmer() {
+    keep_ = false;
+    used_ = 0;
+    kept_ = 0;
+    dropped_ = 0;
+
+    pugi::xml_node skim = Configuration::get()->section("Skim");
+    if (!skim)
+        return;
+
+    file_name_ = skim.attribute("file").as_string("skim.ldf");
+    string source = skim.attribute("source").as_string("");
+    if (source.empty())
+        throw GeneralException("Skim: the source .ldf file is required"
+                               " for the DIR and HEAD records");
+
+    const double inf = numeric_limits<double>::infinity();
+    for (pugi::xml_node node = skim.child("Select"); node;
+         node = node.next_sibling("Select")) {
+        Selection s;
+        s.type = node.attribute("type").as_string("");
+        s.subtype = node.attribute("subtype").as_string("");
+        s.emin = node.attribute("emin").as_double(-inf);
+        s.emax = node.attribute("emax").as_double(inf);
+        s.minHits = node.attribute("min_hits").as_uint(1);
+        selections_.push_back(s);
+    }
+    hits_.resize(selections_.size(), 0);
+
+    /** DIR and HEAD records are the first two of the source */
+    ifstream in(source.c_str(), ios::in | ios::binary);
+    vector<char> header(2 * recordBytes);
+    if (!in.read(&header[0], header.size()) ||
+        memcmp(&header[0], "DIR ", 4) != 0 ||
+        memcmp(&header[recordBytes], "HEAD", 4) != 0) {
+        stringstream ss;
+        ss << "Skim: could not read DIR and HEAD records from '"
+           << source << "'";
+        throw IOException(ss.str());
+    }
+    output_.assign(&header[0], header.size());
+    AsyncWriter::get()->Open(file_name_, true);
+    AsyncWriter::get()->Write(file_name_, output_);
+    /* Registered after the AsyncWriter, so it runs before its shutdown */
+    atexit(FinishAtExit);
+
+    record_.resize(recordWords);
+    enabled_ = true;
+
+    Messenger m;
+    stringstream ss;
+    ss << "Skim: " << selections_.size() << " selection(s), spills to "
+       << file_name_;
+    m.detail(ss.str());
+}
+
+void Skimmer::FinishAtExit() {
+    try {
+        if (instance != NULL)
+            instance->Finish();
+    } catch (IOException &err) {
+        Messenger m;
+        m.warning(err.what());
+    }
+}
+
+void Skimmer::Select(const vector<ChanEvent*>& eventList) {
+    if (keep_)
+        return;
+    for (unsigned i = 0; i < hits_.size(); ++i)
+        hits_[i] = 0;
+
+    for (vector<ChanEvent*>::const_iterator it = eventList.begin();
+         it != eventList.end(); ++it) {
+        const Identifier& id = (*it)->GetChanID();
+        double energy = (*it)->GetEnergy();
+        for (unsigned i = 0; i < selections_.size(); ++i) {
+            const Selection& s = selections_[i];
+            if (!s.type.empty() && s.type != id.GetType())
+                continue;
+            if (!s.subtype.empty() && s.subtype != id.GetSubtype())
+                continue;
+            if (energy < s.emin || energy > s.emax)
+                continue;
+            if (++hits_[i] >= s.minHits) {
+                keep_ = true;
+                return;
+            }
+        }
+    }
+}
+
+void Skimmer::EndSpill(const word_t* data, unsigned long nWords) {
+    if (keep_) {
+        WriteSpill(data, nWords);
+        ++kept_;
+    } else {
+        vector<word_t> reduced;
+        if (Reduce(data, nWords, reduced))
+            WriteSpill(&reduced[0], reduced.size());
+        ++dropped_;
+    }
+    keep_ = false;
+    if (!output_.empty())
+        AsyncWriter::get()->Write(file_name_, output_);
+}
+
+bool Skimmer::Reduce(const word_t* data, unsigned long nWords,
+                     vector<word_t>& reduced) const {
+    bool content = false;
+    unsigned long pos = 0;
+    while (pos + 1 < nWords) {
+        word_t lenRec = data[pos];
+        word_t vsn = data[pos + 1];
+        if (lenRec < 2 || pos + lenRec > nWords)
+            return false;
+        if (vsn < maxVsn) {
+            /** Module buffer, the statistics blocks only */
+            size_t start = reduced.size();
+            reduced.push_back(2);
+            reduced.push_back(vsn);
+            unsigned long event = pos + 2;
+            while (event < pos + lenRec) {
+                word_t headerLength = (data[event] & 0x0001F000) >> 12;
+                word_t eventLength = (data[event] & 0x1FFE0000) >> 17;
+                if (eventLength == 0 || event + eventLength > pos + lenRec)
+                    break;
+                if (headerLength == statsHeaderLength) {
+                    reduced.insert(reduced.end(), data + event,
+                                   data + event + eventLength);
+                    content = true;
+                }
+                event += eventLength;
+            }
+            reduced[start] = reduced.size() - start;
+        } else {
+            /** Clock and end of spill buffers are kept */
+            reduced.insert(reduced.end(), data + pos, data + pos + lenRec);
+            if (vsn != endVsn)
+                content = true;
+        }
+        pos += lenRec;
+    }
+    return content;
+}
+
+void Skimmer::WriteSpill(const word_t* data, unsigned long nWords) {
+    /** Last buffer of the spill goes alone in the last chunk */
+    const word_t end[2] = {2, endVsn};
+    if (nWords >= 2 && data[nWords - 2] == 2 && data[nWords - 1] == endVsn)
+        nWords -= 2;
+
+    unsigned total = (nWords + chunkWords - 1) / chunkWords + 1;
+    unsigned number = 0;
+    for (unsigned long pos = 0; pos < nWords; pos += chunkWords) {
+        unsigned long n = nWords - pos;
+        if (n > chunkWords)
+            n = chunkWords;
+        WriteChunk(data + pos, n, total, number++);
+    }
+    WriteChunk(end, 2, total, number);
+}
+
+void Skimmer::WriteChunk(const word_t* data, unsigned long nWords,
+                         unsigned total, unsigned number) {
+    if (used_ + nWords + 4 > recordWords)
+        EndRecord();
+    record_[used_++] = (nWords + 3) * sizeof(word_t);
+    record_[used_++] = total;
+    record_[used_++] = number;
+    memcpy(&record_[used_], data, nWords * sizeof(word_t));
+    used_ += nWords;
+    record_[used_++] = pixie::U_DELIMITER;
+}
+
+void Skimmer::AddRecord(const char* type, const vector<word_t>& data) {
+    word_t size = data.size();
+    output_.append(type, 4);
+    output_.append(reinterpret_cast<const char*>(&size), sizeof(word_t));
+    output_.append(reinterpret_cast<const char*>(&data[0]),
+                   data.size() * sizeof(word_t));
+}
+
+void Skimmer::EndRecord() {
+    if (used_ == 0)
+        return;
+    fill(record_.begin() + used_, record_.end(), pixie::U_DELIMITER);
+    AddRecord("DATA", record_);
+    used_ = 0;
+}
+
+void Skimmer::Finish() {
+    if (!enabled_)
+        return;
+    EndRecord();
+    vector<word_t> eof(recordWords, pixie::U_DELIMITER);
+    AddRecord("EOF ", eof);
+    AddRecord("EOF ", eof);
+    AsyncWriter::get()->Write(file_name_, output_);
+    enabled_ = false;
+
+    Messenger m;
+    stringstream ss;
+    ss << "Skim: " << kept_ << " spill(s) kept, " << dropped_
+       << " dropped (statistics kept) in " << file_name_;
+    m.detail(ss.str());
+}
@@ -0,0 +1,99 @@
+/** \file SparseHistogram.cpp
+ *
+ * Accumulation of large, mostly empty 2D plots
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#include "Exceptions.hpp"
+#include "Plots.hpp"
+#include "SparseHistogram.hpp"
+
+using namespace std;
+
+namespace {
+    /** Fraction of all the tiles in use at which the histogram is
+     * considered dense and promoted */
+    const unsigned promoteFraction = 4;
+}
+
+SparseHistogram::SparseHistogram(int dammId, int xSize, int ySize)
+{
+    if (xSize <= 0 || ySize <= 0) {
+        stringstream ss;
+        ss << "SparseHistogram: Histogram " << dammId
+           << " has incorrect size " << xSize << " x " << ySize;
+        throw HistogramException(ss.str());
+    }
+    dammId_ = dammId;
+    xSize_ = xSize;
+    ySize_ = ySize;
+    xTiles_ = (xSize + tileMask) >> tileBits;
+    int yTiles = (ySize + tileMask) >> tileBits;
+    tiles_.resize(xTiles_ * yTiles, -1);
+    maxTiles_ = tiles_.size() / promoteFraction;
+    if (maxTiles_ == 0)
+        maxTiles_ = 1;
+    promoted_ = false;
+}
+
+void SparseHistogram::FillDirect(int x, int y, int weight) const
+{
+    if (weight == 1)
+        count1cc_(dammId_, x, y);
+    else
+        add2cc_(dammId_, x, y, weight);
+}
+
+void SparseHistogram::Set(int x, int y, int value)
+{
+    if (!promoted_ && x >= 0 && x < xSize_ && y >= 0 && y < ySize_) {
+        int slot = tiles_[(y >> tileBits) * xTiles_ + (x >> tileBits)];
+        if (slot >= 0)
+            counts_[(slot << (2 * tileBits)) +
+                    ((y & tileMask) << tileBits) + (x & tileMask)] = 0;
+    }
+    set2cc_(dammId_, x, y, value);
+}
+
+int SparseHistogram::NewTile(int tile)
+{
+    if (used_.size() >= maxTiles_) {
+        Flush();
+        promoted_ = true;
+        vector<int>().swap(tiles_);
+        vector<int>().swap(used_);
+        vector<int>().swap(counts_);
+        return -1;
+    }
+    int slot = used_.size();
+    used_.push_back(tile);
+    tiles_[tile] = slot;
+    if (counts_.size() < used_.size() * tileSize * tileSize)
+        counts_.resize(used_.size() * tileSize * tileSize, 0);
+    return slot;
+}
+
+void SparseHistogram::Flush()
+{
+    /** Tiles are written in the order of the matrix */
+    vector<int> order(used_);
+    sort(order.begin(), order.end());
+    for (vector<int>::const_iterator it = order.begin();
+         it != order.end(); ++it) {
+        int x0 = (*it % xTiles_) << tileBits;
+        int y0 = (*it / xTiles_) << tileBits;
+        int* cell = &counts_[tiles_[*it] << (2 * tileBits)];
+        for (int y = 0; y < tileSize; ++y) {
+            for (int x = 0; x < tileSize; ++x, ++cell) {
+                if (*cell == 0)
+                    continue;
+                add2cc_(dammId_, x0 + x, y0 + y, *cell);
+                *cell = 0;
+            }
+        }
+        tiles_[*it] = -1;
+    }
+    used_.clear();
+}
@@ -29,29 +29,102 @@ StatsData::StatsData()
 
   bzero(oldData, sizeof(oldData));
   bzero(data, sizeof(data));
+  bzero(current, sizeof(current));
+  bzero(interval, sizeof(interval));
+  bzero(total, sizeof(total));
+  for (size_t i = 0; i < maxId; ++i)
+      hasInterval[i] = false;
 
   firstTime = NAN;
+  blocks = 0;
 }
 
 /** Copy the statistics data from the data stream to a memory block,
  *   preserving a copy of the old statistics data so that the incremental
  *   change can be determined */
  
-void StatsData::DoStatisticsBlock(word_t *buf, int vsn)
+bool StatsData::DoStatisticsBlock(word_t *buf, int vsn)
 {
-  if (memcmp(data[vsn], buf, sizeof(word_t)*statSize) != 0) {
-    memcpy(oldData[vsn], data[vsn], sizeof(word_t)*statSize);
-    memcpy(data[vsn], buf, sizeof(word_t)*statSize);    
-    if (firstTime == NAN)
-	firstTime = GetRealTime();
-    if (vsn == 0) {
+  if (vsn < 0 || vsn >= (int)maxVsn)
+      return false;
+  if (memcmp(data[vsn], buf, sizeof(word_t)*statSize) == 0)
+      return false;
+
+  memcpy(oldData[vsn], data[vsn], sizeof(word_t)*statSize);
+  memcpy(data[vsn], buf, sizeof(word_t)*statSize);
+  // NaN compares unequal to everything, NAN included
+  if (firstTime != firstTime)
+      firstTime = GetRealTime(vsn);
+  Decode(vsn);
+  ++blocks;
 #ifdef VERBOSE
-	cout << "Got stats block at time " << GetRealTime() << endl;
+  if (vsn == 0)
+      cout << "Got stats block at time " << GetRealTime() << endl;
 #endif
-    }
+  return true;
+}
+
+/** Decodes the counters of the module channels and takes the change
+ * since the previous block. A counter going backwards means the module
+ * was restarted (new run), then the block only serves as a new start. */
+void StatsData::Decode(unsigned int mod)
+{
+  // from Pixie16DSP_r15428.var
+  const size_t offset = 0x4a340;
+  const size_t rtPosHi = 0x4a340 - offset;
+  const size_t rtPosLo = 0x4a341 - offset;
+  const size_t ltPosHi = 0x4a37f - offset;
+  const size_t ltPosLo = 0x4a38f - offset;
+  const size_t peaksPosHi = 0x4a39f - offset;
+  const size_t peaksPosLo = 0x4a3af - offset;
+  const size_t eventsPosHi = 0x4a41f - offset;
+  const size_t eventsPosLo = 0x4a42f - offset;
+
+  double realTime = Word64(mod, rtPosHi, rtPosLo) *
+                    Globals::get()->clockInSeconds();
+
+  for (unsigned ch = 0; ch < NUMBER_OF_CHANNELS; ++ch) {
+      unsigned id = mod * NUMBER_OF_CHANNELS + ch;
+      Counters previous = current[id];
+
+      Counters& c = current[id];
+      c.realTime = realTime;
+      c.liveTime = Word64(mod, ltPosHi + ch, ltPosLo + ch) *
+                   16.0 * 1.0e-6 / SYSTEM_CLOCK_MHZ;
+      c.fastPeaks = Word64(mod, peaksPosHi + ch, peaksPosLo + ch);
+      c.outCounts = Word64(mod, eventsPosHi + ch, eventsPosLo + ch);
+
+      Counters& d = interval[id];
+      d.realTime = c.realTime - previous.realTime;
+      d.liveTime = c.liveTime - previous.liveTime;
+      d.fastPeaks = c.fastPeaks - previous.fastPeaks;
+      d.outCounts = c.outCounts - previous.outCounts;
+
+      hasInterval[id] = (previous.realTime > 0 &&
+                         d.realTime > 0 && d.liveTime >= 0 &&
+                         d.fastPeaks >= 0 && d.outCounts >= 0);
+      if (!hasInterval[id])
+          continue;
+
+      Counters& t = total[id];
+      t.realTime += d.realTime;
+      t.liveTime += d.liveTime;
+      t.fastPeaks += d.fastPeaks;
+      t.outCounts += d.outCounts;
   }
 }
 
+double StatsData::DeadFraction(const Counters& c)
+{
+  if (c.realTime <= 0 || c.liveTime <= 0 || c.fastPeaks <= 0)
+      return 0;
+  double input = c.fastPeaks / c.liveTime;
+  double output = c.outCounts / c.realTime;
+  if (output >= input)
+      return 0;
+  return 1.0 - output / input;
+}
+
 /** Return the most recent statistics live time for a given id */
 double StatsData::GetCurrTime(unsigned int id) const
 {
@@ -130,3 +203,48 @@ double StatsData::GetRealTime(unsigned int mod) const
 
     return d;
 }
+
+double StatsData::GetInputRate(unsigned int id) const
+{
+  if (!HasInterval(id) || interval[id].liveTime <= 0)
+      return 0;
+  return interval[id].fastPeaks / interval[id].liveTime;
+}
+
+double StatsData::GetOutputRate(unsigned int id) const
+{
+  if (!HasInterval(id))
+      return 0;
+  return interval[id].outCounts / interval[id].realTime;
+}
+
+double StatsData::GetLiveFraction(unsigned int id) const
+{
+  if (!HasInterval(id))
+      return 1;
+  return interval[id].liveTime / interval[id].realTime;
+}
+
+double StatsData::GetDeadFraction(unsigned int id) const
+{
+  if (!HasInterval(id))
+      return 0;
+  return DeadFraction(interval[id]);
+}
+
+double StatsData::GetTotalDeadFraction(unsigned int id) const
+{
+  if (id >= maxId)
+      return 0;
+  return DeadFraction(total[id]);
+}
+
+double StatsData::GetCorrection(unsigned int id) const
+{
+  return 1.0 / (1.0 - GetDeadFraction(id));
+}
+
+double StatsData::GetTotalCorrection(unsigned int id) const
+{
+  return 1.0 / (1.0 - GetTotalDeadFraction(id));
+}
@@ -0,0 +1,65 @@
+/** \file SymmetricHistogram.cpp
+ *
+ * Accumulation of symmetric 2D (gamma-gamma) plots
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#include "Exceptions.hpp"
+#include "Plots.hpp"
+#include "SymmetricHistogram.hpp"
+
+using namespace std;
+
+namespace {
+    /** Number of pairs collected before the matrix is updated */
+    const size_t pairsCapacity = 1 << 18;
+}
+
+SymmetricHistogram::SymmetricHistogram(int dammId, int size)
+{
+    /** Cell index must fit 32 bits */
+    if (size <= 0 || size > (1 << 16)) {
+        stringstream ss;
+        ss << "SymmetricHistogram: Histogram " << dammId
+           << " has incorrect size " << size;
+        throw HistogramException(ss.str());
+    }
+    dammId_ = dammId;
+    size_ = size;
+    capacity_ = pairsCapacity;
+    pairs_.reserve(capacity_);
+}
+
+void SymmetricHistogram::FillDirect(int x, int y) const
+{
+    count1cc_(dammId_, x, y);
+    count1cc_(dammId_, y, x);
+}
+
+void SymmetricHistogram::Flush()
+{
+    if (pairs_.empty())
+        return;
+
+    sort(pairs_.begin(), pairs_.end());
+
+    vector<uint32_t>::const_iterator it = pairs_.begin();
+    while (it != pairs_.end()) {
+        vector<uint32_t>::const_iterator next = it + 1;
+        while (next != pairs_.end() && *next == *it)
+            ++next;
+        int counts = int(next - it);
+        int x = int(*it / size_);
+        int y = int(*it % size_);
+        if (x == y) {
+            add2cc_(dammId_, x, y, 2 * counts);
+        } else {
+            add2cc_(dammId_, x, y, counts);
+            add2cc_(dammId_, y, x, counts);
+        }
+        it = next;
+    }
+    pairs_.clear();
+}
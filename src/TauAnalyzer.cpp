@@ -41,13 +41,7 @@ void TauAnalyzer::Analyze(Trace &trace, const string &aType, const string &aSubt
     if (trace.HasValue("filterEnergy2")) {
 	return;
     }
-    // only do analysis for the proper type and subtype
-    if (type != "" && subtype != "" && 
-	type != aType && subtype != aSubtype ) {
-	return;
-    }
-
-    TraceAnalyzer::Analyze(trace, type, subtype);
+    TraceAnalyzer::Analyze(trace, aType, aSubtype);
 	
     // find the maximum
     Trace::const_iterator itMax=max_element(trace.begin(), trace.end());
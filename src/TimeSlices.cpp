@@ -0,0 +1,300 @@
+/** \file TimeSlices.cpp
+ *
+ * Snapshots of selected histograms over time intervals of the run
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+#include "AsyncWriter.hpp"
+#include "Configuration.hpp"
+#include "DetectorDriver.hpp"
+#include "Exceptions.hpp"
+#include "Globals.hpp"
+#include "Messenger.hpp"
+#include "MtcCycle.hpp"
+#include "TimeSlices.hpp"
+
+using namespace std;
+
+namespace {
+    /** Identifies the file type, followed by version */
+    const char sliceMagic[8] = {'P', 'X', 'S', 'L', 'I', 'C', 'E', '1'};
+
+    /** Number of fills collected before they are merged */
+    const size_t fillsCapacity = 1 << 16;
+
+    template<typename T>
+    void put(string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    bool CellLess(const TimeSlices::Cell& a, const TimeSlices::Cell& b) {
+        if (a.y != b.y)
+            return a.y < b.y;
+        return a.x < b.x;
+    }
+
+    /** Total counts and mean x of the cells */
+    void Moments(const vector<TimeSlices::Cell>& cells,
+                 double& counts, double& mean) {
+        counts = 0;
+        double sum = 0;
+        for (vector<TimeSlices::Cell>::const_iterator it = cells.begin();
+             it != cells.end(); ++it) {
+            counts += it->counts;
+            sum += double(it->counts) * it->x;
+        }
+        mean = (counts != 0) ? sum / counts : 0;
+    }
+}
+
+TimeSlices* TimeSlices::instance = NULL;
+bool TimeSlices::enabled_ = false;
+const uint32_t TimeSlices::version_;
+
+/** Instance is created upon first call */
+TimeSlices* TimeSlices::get() {
+    if (!instance) {
+        instance = new TimeSlices();
+    }
+    return instance;
+}
+
+TimeSlices::TimeSlices() {
+    clock_ = PIXIE;
+    interval_ = 0;
+    rateChange_ = 0;
+    meanShift_ = 0;
+    started_ = false;
+    index_ = 0;
+    sliceStart_ = 0;
+    lastTime_ = 0;
+    previous_.index = 0;
+    previous_.start = 0;
+    previous_.stop = 0;
+
+    pugi::xml_node slices = Configuration::get()->section("TimeSlices");
+    if (!slices)
+        return;
+
+    file_name_ = slices.attribute("file").as_string("slices.bin");
+    interval_ = slices.attribute("interval").as_double(60);
+    if (interval_ <= 0) {
+        stringstream ss;
+        ss << "TimeSlices: interval must be positive, got " << interval_;
+        throw GeneralException(ss.str());
+    }
+    string clock = slices.attribute("clock").as_string("pixie");
+    if (clock == "pixie")
+        clock_ = PIXIE;
+    else if (clock == "wall")
+        clock_ = WALL;
+    else if (clock == "cycle")
+        clock_ = CYCLE;
+    else {
+        stringstream ss;
+        ss << "TimeSlices: unknown clock '" << clock << "'";
+        throw GeneralException(ss.str());
+    }
+    rateChange_ = slices.attribute("rate_change").as_double(0);
+    meanShift_ = slices.attribute("mean_shift").as_double(0);
+
+    for (pugi::xml_node node = slices.child("Histogram"); node;
+         node = node.next_sibling("Histogram")) {
+        ids_.push_back(node.attribute("id").as_int(-1));
+    }
+
+    string header(sliceMagic, sizeof(sliceMagic));
+    put(header, version_);
+    AsyncWriter::get()->Open(file_name_, true);
+    AsyncWriter::get()->Write(file_name_, header);
+    /* Registered after the AsyncWriter, so it runs before its shutdown */
+    atexit(EndAtExit);
+
+    enabled_ = true;
+
+    Messenger m;
+    stringstream ss;
+    ss << "Time slices: " << ids_.size() << " histogram(s) every "
+       << interval_ << " " << (clock_ == CYCLE ? "cycle(s)" : "s")
+       << " to " << file_name_;
+    m.detail(ss.str());
+}
+
+void TimeSlices::EndAtExit() {
+    try {
+        if (instance != NULL)
+            instance->EndSlice();
+    } catch (IOException &err) {
+        Messenger m;
+        m.warning(err.what());
+    }
+}
+
+int TimeSlices::Slot(int dammId, int dims) {
+    if (!enabled_ || find(ids_.begin(), ids_.end(), dammId) == ids_.end())
+        return -1;
+    Histogram h;
+    h.dammId = dammId;
+    h.dims = dims;
+    h.capacity = fillsCapacity;
+    histograms_.push_back(h);
+    return histograms_.size() - 1;
+}
+
+void TimeSlices::Compact(Histogram& h) {
+    sort(h.fills.begin(), h.fills.end(), CellLess);
+    vector<Cell>::iterator out = h.fills.begin();
+    for (vector<Cell>::const_iterator it = h.fills.begin();
+         it != h.fills.end(); ++it) {
+        if (out != h.fills.begin() && !CellLess(*(out - 1), *it)) {
+            (out - 1)->counts += it->counts;
+            continue;
+        }
+        *out++ = *it;
+    }
+    h.fills.erase(out, h.fills.end());
+    /** Many distinct cells, allow more fills before the next merge */
+    h.capacity = max(fillsCapacity, 2 * h.fills.size());
+}
+
+double TimeSlices::SlicePosition(double time) const {
+    switch (clock_) {
+        case WALL:
+            return DetectorDriver::get()->GetWallTime(time);
+        case CYCLE:
+            return MtcCycle::get()->CycleNumber();
+        default:
+            return time * Globals::get()->clockInSeconds();
+    }
+}
+
+void TimeSlices::Advance(double time) {
+    double position = SlicePosition(time);
+    unsigned index = (unsigned)floor(position / interval_);
+    if (started_ && index != index_)
+        EndSlice();
+    if (!started_) {
+        started_ = true;
+        index_ = index;
+        sliceStart_ = position;
+    }
+    lastTime_ = position;
+}
+
+void TimeSlices::EndSlice() {
+    if (!started_)
+        return;
+    started_ = false;
+
+    Snapshot current;
+    current.index = index_;
+    current.start = sliceStart_;
+    current.stop = lastTime_;
+
+    string data;
+    put(data, (uint32_t)current.index);
+    put(data, current.start);
+    put(data, current.stop);
+    put(data, (uint32_t)histograms_.size());
+    for (vector<Histogram>::iterator it = histograms_.begin();
+         it != histograms_.end(); ++it) {
+        Compact(*it);
+        vector<Cell>& cells = current.histograms[it->dammId];
+        for (vector<Cell>::const_iterator c = it->fills.begin();
+             c != it->fills.end(); ++c)
+            if (c->counts != 0)
+                cells.push_back(*c);
+        it->fills.clear();
+        it->capacity = fillsCapacity;
+
+        put(data, (int32_t)it->dammId);
+        put(data, (uint32_t)cells.size());
+        for (vector<Cell>::const_iterator c = cells.begin();
+             c != cells.end(); ++c) {
+            put(data, (int32_t)c->x);
+            put(data, (int32_t)c->y);
+            put(data, (int32_t)c->counts);
+        }
+    }
+    AsyncWriter::get()->Write(file_name_, data);
+
+    if (!previous_.histograms.empty())
+        CompareSlices(current);
+    previous_ = current;
+}
+
+void TimeSlices::CompareSlices(const Snapshot& current) const {
+    if (rateChange_ <= 0 && meanShift_ <= 0)
+        return;
+    double span = current.stop - current.start;
+    double previousSpan = previous_.stop - previous_.start;
+
+    Messenger m;
+    for (map<int, vector<Cell> >::const_iterator it =
+            current.histograms.begin();
+         it != current.histograms.end(); ++it) {
+        map<int, vector<Cell> >::const_iterator prev =
+            previous_.histograms.find(it->first);
+        if (prev == previous_.histograms.end())
+            continue;
+        double counts, mean, previousCounts, previousMean;
+        Moments(it->second, counts, mean);
+        Moments(prev->second, previousCounts, previousMean);
+
+        stringstream ss;
+        if (rateChange_ > 0 && span > 0 && previousSpan > 0 &&
+            previousCounts > 0) {
+            double ratio = (counts / span) / (previousCounts / previousSpan);
+            if (fabs(ratio - 1) > rateChange_)
+                ss << " rate x" << ratio;
+        }
+        if (meanShift_ > 0 && counts > 0 && previousCounts > 0 &&
+            fabs(mean - previousMean) > meanShift_)
+            ss << " mean " << previousMean << " -> " << mean;
+        if (!ss.str().empty()) {
+            stringstream msg;
+            msg << "Time slice " << current.index << ", histogram "
+                << it->first << ":" << ss.str();
+            m.warning(msg.str());
+        }
+    }
+}
+
+void TimeSlices::Diff(const Snapshot& a, const Snapshot& b, Snapshot& diff) {
+    diff.index = b.index;
+    diff.start = a.start;
+    diff.stop = b.stop;
+    diff.histograms.clear();
+
+    const vector<Cell> none;
+    for (map<int, vector<Cell> >::const_iterator it = b.histograms.begin();
+         it != b.histograms.end(); ++it) {
+        map<int, vector<Cell> >::const_iterator ia =
+            a.histograms.find(it->first);
+        const vector<Cell>& cellsA =
+            (ia != a.histograms.end()) ? ia->second : none;
+        const vector<Cell>& cellsB = it->second;
+        vector<Cell>& out = diff.histograms[it->first];
+
+        vector<Cell>::const_iterator ca = cellsA.begin();
+        vector<Cell>::const_iterator cb = cellsB.begin();
+        while (ca != cellsA.end() || cb != cellsB.end()) {
+            Cell c;
+            if (cb == cellsB.end() ||
+                (ca != cellsA.end() && CellLess(*ca, *cb))) {
+                c = *ca++;
+                c.counts = -c.counts;
+            } else if (ca == cellsA.end() || CellLess(*cb, *ca)) {
+                c = *cb++;
+            } else {
+                c = *cb++;
+                c.counts -= (ca++)->counts;
+            }
+            if (c.counts != 0)
+                out.push_back(c);
+        }
+    }
+}
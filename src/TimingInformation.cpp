@@ -9,8 +9,10 @@ Written: S.V. Paulauskas 09 May 2011
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string>
 
+#include "ColumnFile.hpp"
 #include "RawEvent.hpp"
 #include "TimingInformation.hpp"
 #include "Trace.hpp"
@@ -19,9 +21,16 @@ using namespace std;
 
 map<string, double> TimingInformation::constantsMap;
 TimingInformation::TimingCalMap TimingInformation::calibrationMap;
+double TimingInformation::lengthTime_[NUM_BAR_TYPES];
+double TimingInformation::speedOfLightBar_[NUM_BAR_TYPES];
+double TimingInformation::speedOfLight_;
+double TimingInformation::neutronMass_;
+vector<TimingInformation::TimingCal> 
+    TimingInformation::barCal_[NUM_BAR_TYPES];
+vector<bool> TimingInformation::hasBarCal_[NUM_BAR_TYPES];
 
 //********** Data (Default)**********
-TimingInformation::TimingData::TimingData(void) : trace(emptyTrace)
+TimingInformation::TimingData::TimingData(void) : trace(&emptyTrace)
 {
     aveBaseline    = numeric_limits<double>::quiet_NaN();
     discrimination = numeric_limits<double>::quiet_NaN();
@@ -38,7 +47,7 @@ TimingInformation::TimingData::TimingData(void) : trace(emptyTrace)
 
 
 //********** Data **********
-TimingInformation::TimingData::TimingData(ChanEvent *chan) : trace(chan->GetTrace())
+TimingInformation::TimingData::TimingData(ChanEvent *chan) : trace(&chan->GetTrace())
 {
     //put all the times as ns
     // 11/18/2012 KM: after removal of Trace member, trace is
@@ -71,7 +80,6 @@ TimingInformation::TimingData::TimingData(ChanEvent *chan) : trace(chan->GetTrac
 }
 
 
-#ifdef useroot
 //********** DataRoot **********
 TimingInformation::DataRoot::DataRoot(void) 
 {
@@ -90,16 +98,32 @@ TimingInformation::DataRoot::DataRoot(void)
 	location[i]       = -1;
     }
 }
-#endif
+
+//********** DataRoot::AddColumns **********
+void TimingInformation::DataRoot::AddColumns(ColumnWriter *writer,
+                                             const string &prefix)
+{
+    writer->AddColumn(prefix + "_multiplicity", &multiplicity);
+    for (size_t i = 0; i < maxMultiplicity; i++) {
+        stringstream ss;
+        ss << i;
+        writer->AddColumn(prefix + "_aveBaseline" + ss.str(), &aveBaseline[i]);
+        writer->AddColumn(prefix + "_discrimination" + ss.str(),
+                          &discrimination[i]);
+        writer->AddColumn(prefix + "_highResTime" + ss.str(), &highResTime[i]);
+        writer->AddColumn(prefix + "_maxpos" + ss.str(), &maxpos[i]);
+        writer->AddColumn(prefix + "_maxval" + ss.str(), &maxval[i]);
+        writer->AddColumn(prefix + "_phase" + ss.str(), &phase[i]);
+        writer->AddColumn(prefix + "_stdDevBaseline" + ss.str(),
+                          &stdDevBaseline[i]);
+        writer->AddColumn(prefix + "_tqdc" + ss.str(), &tqdc[i]);
+        writer->AddColumn(prefix + "_location" + ss.str(), &location[i]);
+    }
+}
 
 //********** BarData **********
-TimingInformation::BarData::BarData(const TimingData &Right, const TimingData &Left, const TimingCal &cal, const string &type) 
+TimingInformation::BarData::BarData(const TimingData &Right, const TimingData &Left, const TimingCal &cal, BarType type) 
 {
-    //Clear the maps that hold this information
-    timeOfFlight.clear();
-    energy.clear();
-    corTimeOfFlight.clear();
-    
     //Set the values for the useful bar stuff. 
     lMaxVal   = Left.maxval;
     rMaxVal   = Right.maxval;
@@ -116,46 +140,25 @@ TimingInformation::BarData::BarData(const TimingData &Right, const TimingData &L
 
 
 //********** BarEventCheck **********
-bool TimingInformation::BarData::BarEventCheck(const double &timeDiff, const string &type)
+bool TimingInformation::BarData::BarEventCheck(const double &timeDiff, BarType type)
 {
-    if(type == "small") {
-	double lengthSmallTime = TimingInformation::GetConstant("lengthSmallTime");
-	return(fabs(timeDiff) < lengthSmallTime+20);
-    } else if(type == "big") {
-	double lengthBigTime = TimingInformation::GetConstant("lengthBigTime");
-	return(fabs(timeDiff) < lengthBigTime+20);
-    } else
-	return(false);
+    return(fabs(timeDiff) < TimingInformation::lengthTime_[type]+20);
 }
 
 
 //********** CalcFlightPath **********
-double TimingInformation::BarData::CalcFlightPath(double &timeDiff, const TimingCal& cal, const string &type)
+double TimingInformation::BarData::CalcFlightPath(double &timeDiff, const TimingCal& cal, BarType type)
 {
-    if(type == "small") {
-	double speedOfLightSmall = 
-	    TimingInformation::GetConstant("speedOfLightSmall");
-	return(sqrt(cal.z0*cal.z0+
-		    pow(speedOfLightSmall*0.5*timeDiff+cal.xOffset,2)));
-	//return(sqrt(pow(speedOfLightSmall*0.5*timeDiff+cal.xOffset,2)));
-    } else if(type == "big") {
-	double speedOfLightBig = 
-	    TimingInformation::GetConstant("speedOfLightBig");
- 	return(sqrt(cal.z0*cal.z0 +
- 		    pow(speedOfLightBig*0.5*timeDiff+cal.xOffset,2)));
-    } else 
- 	return(numeric_limits<double>::quiet_NaN());
+    double speedOfLightBar = TimingInformation::speedOfLightBar_[type];
+    return(sqrt(cal.z0*cal.z0+
+		pow(speedOfLightBar*0.5*timeDiff+cal.xOffset,2)));
 }
 
 
 //********** CalculateEnergy **********
 double TimingInformation::CalcEnergy(const double &corTOF, const double &z0)
 {
-    double speedOfLight = 
-	TimingInformation::GetConstant("speedOfLight");
-    double neutronMass  = 
-	TimingInformation::GetConstant("neutronMass");
-    return((0.5*neutronMass*pow((z0/corTOF)/speedOfLight, 2))*1000);
+    return((0.5*neutronMass_*pow((z0/corTOF)/speedOfLight_, 2))*1000);
 }
 
  
@@ -196,6 +199,19 @@ TimingInformation::TimingCal TimingInformation::GetTimingCal(const IdentKey &ide
 }
 
 
+//********** MissingBarCal **********
+void TimingInformation::MissingBarCal(BarType type, unsigned int location)
+{
+    cout << endl << endl 
+	 << "Cannot locate detector named " 
+	 << (type == SMALL_BAR ? "small" : "big")
+	 << " at location " << location 
+	 << " in the Timing Calibration!!" 
+	 << endl << "Please check timingCal.txt" << endl << endl;
+    exit(EXIT_FAILURE); 
+}
+
+
 //********** ReadTimingConstants **********
 void TimingInformation::ReadTimingConstants(void)
 {
@@ -224,15 +240,17 @@ void TimingInformation::ReadTimingConstants(void)
     }
     readConstants.close();
 
-    double lengthSmallTime = 
-	(*constantsMap.find("lengthSmallPhysical")).second /
-	(*constantsMap.find("speedOfLightSmall")).second;
-    double lengthBigTime   = 
-	(*constantsMap.find("lengthBigPhysical")).second /
-	(*constantsMap.find("speedOfLightBig")).second;
-
-    constantsMap.insert(make_pair("lengthBigTime", lengthBigTime));
-    constantsMap.insert(make_pair("lengthSmallTime", lengthSmallTime));
+    speedOfLightBar_[SMALL_BAR] = GetConstant("speedOfLightSmall");
+    speedOfLightBar_[BIG_BAR]   = GetConstant("speedOfLightBig");
+    lengthTime_[SMALL_BAR] = 
+	GetConstant("lengthSmallPhysical") / speedOfLightBar_[SMALL_BAR];
+    lengthTime_[BIG_BAR]   = 
+	GetConstant("lengthBigPhysical") / speedOfLightBar_[BIG_BAR];
+    speedOfLight_ = GetConstant("speedOfLight");
+    neutronMass_  = GetConstant("neutronMass");
+
+    constantsMap.insert(make_pair("lengthBigTime", lengthTime_[BIG_BAR]));
+    constantsMap.insert(make_pair("lengthSmallTime", lengthTime_[SMALL_BAR]));
 } //void TimingInformation::ReadTimingConstants
 
 
@@ -266,7 +284,23 @@ void TimingInformation::ReadTimingCalibration(void)
 
 		IdentKey calKey(location, type);
 		
-		calibrationMap.insert(make_pair(calKey, timingcal));
+		bool isNew = 
+		    calibrationMap.insert(make_pair(calKey, timingcal)).second;
+
+		//the bars are also kept in flat tables for the per event use
+		int bar = -1;
+		if (type == "small")
+		    bar = SMALL_BAR;
+		else if (type == "big")
+		    bar = BIG_BAR;
+		if (bar >= 0 && isNew) {
+		    if (location >= barCal_[bar].size()) {
+			barCal_[bar].resize(location + 1);
+			hasBarCal_[bar].resize(location + 1, false);
+		    }
+		    barCal_[bar][location] = timingcal;
+		    hasBarCal_[bar][location] = true;
+		}
 	    } else{
 		timingCalFile.ignore(1000, '\n');
 	    }
@@ -6,7 +6,6 @@
 
 #include <algorithm>
 #include <iostream>
-#include <numeric>
 #include <iomanip>
 
 #include "Trace.hpp"
@@ -43,19 +42,48 @@ void Trace::TrapezoidalFilter(Trace &filter,
     
     //! check if we're going to do something bad here
     for (unsigned int i = lo; i < hi; i++) {
-        int leftSum = accumulate(begin() + i - parms.GetSize(),
-                                 begin() + i - parms.GetRiseSamples() 
-                                 - parms.GetGapSamples(), 0);
-        int rightSum = accumulate(begin() + i - parms.GetRiseSamples(),
-                                  begin() + i, 0);
+        int leftSum = WindowSum(i - parms.GetSize(),
+                                i - parms.GetRiseSamples() 
+                                - parms.GetGapSamples());
+        int rightSum = WindowSum(i - parms.GetRiseSamples(), i);
         filter.push_back(rightSum - leftSum);
     }
 }
 
 
+namespace {
+    /** Running sums of n samples, see Trace::BuildSums() */
+    template<typename T>
+    void RunningSums(const T* samples, size_t n,
+                     vector<int64_t>& sums, vector<int64_t>& squareSums)
+    {
+        sums.resize(n + 1);
+        squareSums.resize(n + 1);
+        sums[0] = squareSums[0] = 0;
+        for (size_t i = 0; i < n; i++) {
+            int64_t sample = samples[i];
+            sums[i + 1] = sums[i] + sample;
+            squareSums[i + 1] = squareSums[i] + sample * sample;
+        }
+    }
+}
+
+void Trace::BuildSums() const
+{
+    if (packed_ != NULL && empty()) {
+        const pixie::halfword_t* samples =
+            packed_->empty() ? NULL : &(*packed_)[0];
+        RunningSums(samples, packed_->size(), sums_, squareSums_);
+    } else {
+        const int* samples = empty() ? NULL : &(*this)[0];
+        RunningSums(samples, size(), sums_, squareSums_);
+    }
+}
+
+
 double Trace::DoBaseline(unsigned int lo, unsigned int numBins)
 {
-    if (size() < lo + numBins) {
+    if (NumSamples() < lo + numBins) {
         cerr << "Bad range in baseline calculation." << endl;
         return NAN;
     }
@@ -65,11 +93,8 @@ double Trace::DoBaseline(unsigned int lo, unsigned int numBins)
     if (baselineLow == lo && baselineHigh == hi)
         return GetValue("baseline");
 
-    double sum = accumulate(begin() + lo, begin() + hi, 0.0);
-    double mean = sum / numBins;
-    double sq_sum = inner_product(begin() + lo, begin() + hi,
-                                  begin() + lo, 0.0);
-    double std_dev = sqrt(sq_sum / numBins - mean * mean);
+    double mean = WindowMean(lo, hi);
+    double std_dev = sqrt(WindowVariance(lo, hi));
 
     SetValue("baseline", mean);
     SetValue("sigmaBaseline", std_dev);
@@ -85,14 +110,17 @@ unsigned int Trace::DoDiscrimination(unsigned int lo, unsigned int numBins)
 {
     unsigned int high = lo+numBins;
 
-    if(size() < high)
+    if(NumSamples() < high)
         return pixie::U_DELIMITER;
     
     int discrim = 0, max = GetValue("maxpos");
     double baseline = GetValue("baseline");
 
-    for(unsigned int i = max+lo; i <= max+high; i++)
-	discrim += at(i)-baseline;
+    if(NumSamples() < max + high + 1)
+        return pixie::U_DELIMITER;
+
+    // the window includes both ends
+    discrim = WindowSum(max+lo, max+high+1) - baseline*(numBins+1);
     
     InsertValue("discrim", discrim);
     
@@ -103,14 +131,11 @@ unsigned int Trace::DoQDC(unsigned int lo, unsigned int numBins)
 {
     unsigned int high = lo+numBins;
 
-    if(size() < high)
+    if(NumSamples() < high)
 	return pixie::U_DELIMITER;
 
     double baseline = GetValue("baseline");
-    double qdc = 0;
-
-    for(unsigned int i = lo; i < high; i++)
-	qdc += at(i)-baseline;
+    double qdc = WindowSum(lo, high) - baseline*numBins;
 
     InsertValue("tqdc", qdc);
 
@@ -123,33 +148,36 @@ unsigned int Trace::FindMaxInfo(unsigned int lo, unsigned int numBins)
     unsigned int hi = constants.GetConstant("waveformHigh");
     numBins = lo + hi;
     
-    if(size() < lo + numBins)
+    if(NumSamples() < lo + numBins)
        return pixie::U_DELIMITER;
     
-    Trace::const_iterator itTrace = max_element(begin()+lo, end()-lo);
-    
-    int maxPos = int(itTrace-begin());
+    // first maximum in [lo, NumSamples() - lo)
+    size_type maxPos = lo;
+    for (size_type i = lo + 1; i < NumSamples() - lo; i++) {
+        if (Sample(i) > Sample(maxPos))
+            maxPos = i;
+    }
 
     DoBaseline(0,maxPos-constants.GetConstant("waveformLow"));
 
-    InsertValue("maxpos", int(itTrace-begin()));
-    InsertValue("maxval", int(*itTrace)-GetValue("baseline"));
+    InsertValue("maxpos", int(maxPos));
+    InsertValue("maxval", int(Sample(maxPos))-GetValue("baseline"));
 
-    return (itTrace-begin());
+    return (maxPos);
 }
 
 void Trace::Plot(int id)
 {
-    for (size_type i=0; i < size(); i++) {
-        histo.Plot(id, i, 1, at(i));
+    for (size_type i=0; i < NumSamples(); i++) {
+        histo.Plot(id, i, 1, Sample(i));
     }
 }
 
 void Trace::Plot(int id, int row)
 {
-    for (size_type i=0; i < size(); i++) 
+    for (size_type i=0; i < NumSamples(); i++) 
       {
-	histo.Plot(id, i, row, at(i)); /* used in plotting 7500; by YX
+	histo.Plot(id, i, row, Sample(i)); /* used in plotting 7500; by YX
 					* histo is a objective of the class Plot, 
 					* however, histo is a member of the class Trace
 					* the "Plot" function used here should be member function of the class Plot
@@ -165,8 +193,8 @@ void Trace::Plot(int id, int row)
 
 void Trace::ScalePlot(int id, double scale)
 {
-    for (size_type i=0; i < size(); i++) {
-        histo.Plot(id, i, 1, abs(at(i)) / scale);
+    for (size_type i=0; i < NumSamples(); i++) {
+        histo.Plot(id, i, 1, abs(Sample(i)) / scale);
     }
 }
 
@@ -175,8 +203,8 @@ void Trace::ScalePlot(int id, int row, double scale) /* used for plotting 7502
 						      * by YX
 						      */
 {
-    for (size_type i=0; i < size(); i++) {
-        histo.Plot(id, i, row, abs(at(i)) / scale);
+    for (size_type i=0; i < NumSamples(); i++) {
+        histo.Plot(id, i, row, abs(Sample(i)) / scale);
 
 	//---------------- by Yongchi Xiao; 04/09/2015 ------------//
 	/*
@@ -191,14 +219,14 @@ void Trace::ScalePlot(int id, int row, double scale) /* used for plotting 7502
 
 void Trace::OffsetPlot(int id, double offset)
 {
-    for (size_type i=0; i < size(); i++) {
-        histo.Plot(id, i, 1, max(0., at(i) - offset));
+    for (size_type i=0; i < NumSamples(); i++) {
+        histo.Plot(id, i, 1, max(0., Sample(i) - offset));
     }
 }
 
 void Trace::OffsetPlot(int id, int row, double offset)
 {
-    for (size_type i=0; i < size(); i++) {
-        histo.Plot(id, i, row, max(0., at(i) - offset));
+    for (size_type i=0; i < NumSamples(); i++) {
+        histo.Plot(id, i, row, max(0., Sample(i) - offset));
     }
 }
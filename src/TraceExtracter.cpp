@@ -45,10 +45,8 @@ void TraceExtracter::Analyze(Trace &trace,
 {   
     using namespace dammIds::trace::extracter;
 
-    if (type ==  aType && 
-        subtype == aSubtype && 
-        numTracesAnalyzed < numTraces) {	
-        TraceAnalyzer::Analyze(trace, type, subtype);	
+    if (numTracesAnalyzed < numTraces) {	
+        TraceAnalyzer::Analyze(trace, aType, aSubtype);	
         trace.OffsetPlot(D_TRACE + numTracesAnalyzed, trace.DoBaseline(1,20) );
         EndAnalyze(trace);
     }
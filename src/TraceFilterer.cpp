@@ -128,13 +128,16 @@ void TraceFilterer::Analyze(Trace &trace,
 {
     using namespace dammIds::trace::tracefilterer;
 
+    hitId_ = trace.GetHitId();
+    hitTime_ = trace.GetHitTime();
+
     if (level >= 5) {
         const size_t baselineBins = 30;
         const double deviationCut = fastThreshold / 4. /
                                     fastParms.GetRiseSamples();
 
         double trailingBaseline  = trace.DoBaseline(
-                                trace.size() - baselineBins - 1, baselineBins);
+                                trace.NumSamples() - baselineBins - 1, baselineBins);
 
 	//--------------------- by Yongchi Xiao --------------------
 	
@@ -281,9 +284,10 @@ const TraceFilterer::PulseInfo& TraceFilterer::FindPulse(Trace::iterator begin,
 	//cout << "sample:     " << sample << endl;
 	//----------------------------------------------
         
-        RandomPool* randoms = RandomPool::get();
         if (sample < energyFilter.size()) {
-	  pulse.energy = energyFilter[sample] + randoms->Get();	    
+	  pulse.energy = energyFilter[sample] +
+	      RandomPool::Get(RandomPool::TRACE_FILTER, hitId_, hitTime_,
+			      pulse.time);	    
             // subtract an energy filter baseline
 	  //cout << "---presample--- " << presample << endl; // by Yongchi Xiao; 05/06/2015
 
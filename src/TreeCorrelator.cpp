@@ -1,4 +1,5 @@
 #include "TreeCorrelator.hpp"
+#include "Configuration.hpp"
 #include "Globals.hpp"
 #include "Exceptions.hpp"
 #include "Messenger.hpp"
@@ -53,6 +54,26 @@ Place* TreeCorrelator::place(string name) {
     return element->second;
 }
 
+unsigned TreeCorrelator::handle(const string& name) const {
+    map<string, unsigned>::const_iterator element = handles_.find(name);
+    if (element == handles_.end()) {
+        stringstream ss;
+        ss << "TreeCorrelator: place " << name
+           << " doesn't exist " << endl;
+        throw TreeCorrelatorException(ss.str());
+    }
+    return element->second;
+}
+
+void TreeCorrelator::resetPlaces() {
+    for (vector<Place*>::iterator it = Place::dirty_list_.begin();
+         it != Place::dirty_list_.end(); ++it) {
+        (*it)->dirty_ = false;
+        (*it)->reset();
+    }
+    Place::dirty_list_.clear();
+}
+
 void TreeCorrelator::addChild(string parent, string child, 
                              bool coin, bool verbose) {
     if (places_.count(parent) == 1 && places_.count(child) == 1) {
@@ -152,6 +173,12 @@ void TreeCorrelator::createPlace(map<string, string>& params,
             }
             Place* current = builder.create(params, verbose);
             places_[(*it)] = current;
+            if (replace) {
+                placeList_[handles_[(*it)]] = current;
+            } else {
+                handles_[(*it)] = placeList_.size();
+                placeList_.push_back(current);
+            }
             if (strings::to_bool(params["init"]))
                 current->activate(0.0);
         }
@@ -165,20 +192,10 @@ void TreeCorrelator::createPlace(map<string, string>& params,
 }
 
 void TreeCorrelator::buildTree() {
-    pugi::xml_document doc;
-
     Messenger m;
     m.start("Creating TreeCorrelator");
-    pugi::xml_parse_result result = doc.load_file("Config.xml");
-    if (!result) {
-        stringstream ss;
-        ss << "DetectorDriver: error parsing file Config.xml";
-        ss << " : " << result.description();
-        m.fail();
-        throw IOException(ss.str());
-    }
 
-    pugi::xml_node tree = doc.child("Configuration").child("TreeCorrelator");
+    pugi::xml_node tree = Configuration::get()->section("TreeCorrelator");
     bool verbose = tree.attribute("verbose").as_bool(false);
 
     Walker walker;
@@ -4,12 +4,15 @@ Processes information from the VANDLE Bars
 Updated: S.V. Paulauskas 26 July 2010  
 Original M. Madurga
 *************************************/
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
 
 #include <cmath>
 
 #include "DammPlotIds.hpp"
+#include "DetectorLibrary.hpp"
 #include "Globals.hpp"
 #include "RawEvent.hpp"
 #include "VandleProcessor.hpp"
@@ -85,6 +88,43 @@ namespace dammIds {
 using namespace std;
 using namespace dammIds::vandle;
 
+namespace {
+    /** Number of locations (largest + 1) used by the given type
+     * for either of two subtypes */
+    unsigned int NumLocations(const string &type, const string &subtypeA,
+                              const string &subtypeB)
+    {
+        const DetectorLibrary *modChan = DetectorLibrary::get();
+        const set<int> &locsA = modChan->GetLocations(type, subtypeA);
+        const set<int> &locsB = modChan->GetLocations(type, subtypeB);
+        int num = 0;
+        if (!locsA.empty())
+            num = max(num, *locsA.rbegin() + 1);
+        if (!locsB.empty())
+            num = max(num, *locsB.rbegin() + 1);
+        return num;
+    }
+}
+
+//*********** BarTable **********
+void VandleProcessor::BarTable::Resize(unsigned int numLocations)
+{
+    ends.resize(2 * numLocations);
+    hasEnd.resize(2 * numLocations, false);
+    bars.resize(numLocations);
+}
+
+void VandleProcessor::BarTable::Clear(void)
+{
+    for (vector<unsigned int>::const_iterator it = touched.begin();
+         it != touched.end(); ++it) {
+        hasEnd[2 * (*it) + RIGHT] = false;
+        hasEnd[2 * (*it) + LEFT] = false;
+    }
+    touched.clear();
+    built.clear();
+}
+
 
 //*********** VandleProcessor **********
 VandleProcessor::VandleProcessor():
@@ -106,6 +146,14 @@ void VandleProcessor::DeclarePlots(void)
     const unsigned int numSmallEnds = S7;
     const unsigned int numBigEnds   = S4;
 
+    //Size the tables once, unexpected locations will extend them
+    barTables[SMALL_BAR].Resize(NumLocations("vandleSmall", "right", "left"));
+    barTables[BIG_BAR].Resize(NumLocations("vandleBig", "right", "left"));
+    tvandleTable.Resize(NumLocations("tvandle", "right", "left"));
+    unsigned int numStarts = NumLocations("liquid_scint", "beta", "liquid");
+    starts.resize(2 * numStarts);
+    hasStart.resize(2 * numStarts, false);
+
     //Plots used for debugging
     DeclareHistogram1D(D_PROBLEMS, S5, "1D Debugging");
     DeclareHistogram2D(DD_PROBLEMS, S7, S7, "2D Debugging");
@@ -301,28 +349,24 @@ bool VandleProcessor::RetrieveData(RawEvent &event)
     static const vector<ChanEvent*> &tvandleEvents = 
 	event.GetSummary("tvandle")->GetList();
 
-    //Construct and fill the vector for the startEvents
-    vector<ChanEvent*> startEvents;
-    startEvents.insert(startEvents.end(), 
-		       betaStarts.begin(), betaStarts.end());
-    startEvents.insert(startEvents.end(), 
-		       liquidStarts.begin(), liquidStarts.end());
-
     if(smallEvents.empty() && bigEvents.empty() ) {
         plot(D_PROBLEMS, 27); //DEBUGGING
 	return(false);
     }
      
-    FillMap(smallEvents, "small", smallMap);
-    FillMap(bigEvents, "big", bigMap);
-    FillMap(tvandleEvents, "tvandle", tvandleMap);
-    FillMap(startEvents, "start", startMap);
+    FillEnds(smallEvents, 0, barTables[SMALL_BAR]);
+    FillEnds(bigEvents, dammIds::BIG_OFFSET, barTables[BIG_BAR]);
+    FillEnds(tvandleEvents, dammIds::TVANDLE_OFFSET, tvandleTable);
+    FillStarts(betaStarts);
+    FillStarts(liquidStarts);
+    sort(startSlots.begin(), startSlots.end());
     
-    //Make the VandleBars - small/big will be in the same map
-    BuildBars(bigMap, "big", barMap);
-    BuildBars(smallMap, "small", barMap);
+    //Make the VandleBars
+    BuildBars(barTables[BIG_BAR], BIG_BAR);
+    BuildBars(barTables[SMALL_BAR], SMALL_BAR);
     
-    if(barMap.empty()) {
+    if(barTables[SMALL_BAR].built.empty() && 
+       barTables[BIG_BAR].built.empty()) {
 	plot(D_PROBLEMS, 25); //DEBUGGING
 	return(false);
     }
@@ -335,40 +379,51 @@ bool VandleProcessor::RetrieveData(RawEvent &event)
 void VandleProcessor::AnalyzeData(RawEvent& rawev)
 {
     //Analyze the Teeny VANDLE data if there is any
-    if(!tvandleMap.empty() && tvandleMap.size()%2 == 0)
+    if(!tvandleTable.touched.empty())
 	Tvandle();
 
     //Analyze the VANDLE bars if any are present.
-    for (BarMap::iterator itBar = barMap.begin(); 
-	 itBar !=  barMap.end(); itBar++) {
-	if(!(*itBar).second.event)
+    AnalyzeBars(rawev, BIG_BAR);
+    AnalyzeBars(rawev, SMALL_BAR);
+} //void VandleProcessor::AnalyzeData
+
+
+//********** AnalyzeBars **********
+void VandleProcessor::AnalyzeBars(RawEvent& rawev, BarType type)
+{
+    BarTable &table = barTables[type];
+    for (vector<unsigned int>::const_iterator itLoc = table.built.begin(); 
+	 itLoc != table.built.end(); itLoc++) {
+	BarData &bar = table.bars[*itLoc];
+	if(!bar.event)
 	    continue;
 	
 	//Set some useful values.
 	const int resMult = 2; //set resolution of histograms
 	const int resOffset = 200; // offset of histograms
-	unsigned int barLoc = (*itBar).first.first;
+	unsigned int barLoc = *itLoc;
 	unsigned int idOffset = -1;
-	if((*itBar).first.second == "small")
+	if(type == SMALL_BAR)
 	    idOffset = 0;
 	else
 	   idOffset = dammIds::BIG_OFFSET;
 
-	TimingCal calibration =
-	    GetTimingCal((*itBar).first);
+	const TimingCal &calibration =
+	    GetBarCal(type, barLoc);
 	
 	plot(DD_TIMEDIFFBARS+idOffset, 
-	     (*itBar).second.timeDiff*resMult+resOffset, barLoc); 
+	     bar.timeDiff*resMult+resOffset, barLoc); 
 	plot(DD_TQDCAVEVSTDIFF+idOffset, 
-	     (*itBar).second.timeDiff*resMult+resOffset, (*itBar).second.qdc);
+	     bar.timeDiff*resMult+resOffset, bar.qdc);
 	
 	//Loop over the starts in the event	
-	for(TimingDataMap::iterator itStart = startMap.begin(); 
-	    itStart != startMap.end(); itStart++) {
-	    if(!(*itStart).second.dataValid)
+	for(vector<unsigned int>::const_iterator itSlot = startSlots.begin(); 
+	    itSlot != startSlots.end(); itSlot++) {
+	    const TimingData &start = starts[*itSlot];
+	    if(!start.dataValid)
 		continue;
 	    
-	    unsigned int startLoc = (*itStart).first.first;
+	    unsigned int startLoc = *itSlot / 2;
 	    unsigned int barPlusStartLoc = barLoc*2 + startLoc;
 
 	    double tofOffset;
@@ -379,50 +434,50 @@ void VandleProcessor::AnalyzeData(RawEvent& rawev)
 	    
 	    //times are calculated in ns, energy in keV
 	    double TOF = 
-		(*itBar).second.timeAve - (*itStart).second.highResTime + tofOffset; 
+		bar.timeAve - start.highResTime + tofOffset; 
 	    double corTOF = 
-		CorrectTOF(TOF, (*itBar).second.flightPath, calibration.z0); 
+		CorrectTOF(TOF, bar.flightPath, calibration.z0); 
 	    double energy = 
 		CalcEnergy(corTOF, calibration.z0);
 	    
-	    (*itBar).second.timeOfFlight.insert(make_pair(startLoc, TOF));
-	    (*itBar).second.corTimeOfFlight.insert(make_pair(startLoc, corTOF));
-	    (*itBar).second.energy.insert(make_pair(startLoc, energy));
+	    bar.timeOfFlight[*itSlot] = TOF;
+	    bar.corTimeOfFlight[*itSlot] = corTOF;
+	    bar.energy[*itSlot] = energy;
 	    
 	    if(corTOF >= 5) // cut out the gamma prompt
-		plot(DD_TQDCAVEVSENERGY+idOffset, energy, (*itBar).second.qdc);
+		plot(DD_TQDCAVEVSENERGY+idOffset, energy, bar.qdc);
 	    plot(DD_TOFBARS+idOffset, 
 		 TOF*resMult+resOffset, barPlusStartLoc);
 	    plot(DD_TDIFFVSTOF+idOffset, TOF*resMult+resOffset, 
-		 (*itBar).second.timeDiff*resMult+resOffset);
+		 bar.timeDiff*resMult+resOffset);
 	    plot(DD_MAXRVSTOF+idOffset, 
-		 TOF*resMult+resOffset, (*itBar).second.rMaxVal);
+		 TOF*resMult+resOffset, bar.rMaxVal);
 	    plot(DD_MAXLVSTOF+idOffset, 
-		 TOF*resMult+resOffset, (*itBar).second.lMaxVal);
+		 TOF*resMult+resOffset, bar.lMaxVal);
 	    plot(DD_TQDCAVEVSTOF+idOffset, 
-		 TOF*resMult+resOffset, (*itBar).second.qdc);
+		 TOF*resMult+resOffset, bar.qdc);
 
 	    plot(DD_CORTOFBARS, 
 		 corTOF*resMult+resOffset, barPlusStartLoc); 
 	    plot(DD_TDIFFVSCORTOF+idOffset, corTOF*resMult+resOffset, 
-		 (*itBar).second.timeDiff*resMult + resOffset);
+		 bar.timeDiff*resMult + resOffset);
 	    plot(DD_MAXRVSCORTOF+idOffset, 
-		 corTOF*resMult+resOffset, (*itBar).second.rMaxVal);
+		 corTOF*resMult+resOffset, bar.rMaxVal);
 	    plot(DD_MAXLVSCORTOF+idOffset, 
-		 corTOF*resMult+resOffset, (*itBar).second.lMaxVal);
+		 corTOF*resMult+resOffset, bar.lMaxVal);
 	    plot(DD_TQDCAVEVSCORTOF+idOffset, 
-		 corTOF*resMult+resOffset, (*itBar).second.qdc);
+		 corTOF*resMult+resOffset, bar.qdc);
 	    
 	    if(startLoc == 0) {
 		plot(DD_MAXSTART0VSTOF+idOffset, 
-		     TOF*resMult+resOffset, (*itStart).second.maxval);
+		     TOF*resMult+resOffset, start.maxval);
 		plot(DD_MAXSTART0VSCORTOF+idOffset, 
-		     corTOF*resMult+resOffset, (*itStart).second.maxval);
+		     corTOF*resMult+resOffset, start.maxval);
 	    } else if (startLoc == 1) {
  	        plot(DD_MAXSTART1VSCORTOF+idOffset, 
-		     corTOF*resMult+resOffset, (*itStart).second.maxval);
+		     corTOF*resMult+resOffset, start.maxval);
 		plot(DD_MAXSTART1VSCORTOF+idOffset, 
-		     corTOF*resMult+resOffset, (*itStart).second.maxval);
+		     corTOF*resMult+resOffset, start.maxval);
 	    }
 
 	    //Now we will do some Ge related stuff
@@ -439,139 +494,89 @@ void VandleProcessor::AnalyzeData(RawEvent& rawev)
 		} else {
 		    // vetoed stuff
 		    plot(DD_TQDCAVEVSTOF_VETO+idOffset, TOF, 
-			 (*itBar).second.qdc);
+			 bar.qdc);
 		    plot(DD_TOFBARS_VETO+idOffset, TOF, barPlusStartLoc);
 		}
 	    } 
-	} // for(TimingDataMap::iterator itStart
-    } //(BarMap::iterator itBar
-} //void VandleProcessor::AnalyzeData
+	} // for(itSlot
+    } // for(itLoc
+} //void VandleProcessor::AnalyzeBars
 
 
 //********** BuildBars **********
-void VandleProcessor::BuildBars(const TimingDataMap &endMap, const string &type, BarMap &barMap) 
+void VandleProcessor::BuildBars(BarTable &table, BarType type) 
 {
-    for(TimingDataMap::const_iterator itEndA = endMap.begin();
-	itEndA != endMap.end();) {
-
-	TimingDataMap::const_iterator itEndB = itEndA;
-	itEndB++;
-	
-	if(itEndB == endMap.end()) //Handle some shit
-	    break;
-	if((*itEndA).first.first != (*itEndB).first.first) {
-	    itEndA = itEndB;
-	    continue;
-	}
-	if(!(*itEndA).second.dataValid || !(*itEndB).second.dataValid){
-	    itEndA = itEndB;
+    for(vector<unsigned int>::const_iterator itLoc = table.touched.begin();
+	itLoc != table.touched.end(); itLoc++) {
+	unsigned int loc = *itLoc;
+	if(!table.hasEnd[2*loc+RIGHT] || !table.hasEnd[2*loc+LEFT])
 	    continue;
-	}
-	
-	IdentKey barKey((*itEndA).first.first, type); 
-	
-	TimingCal calibrations =
-	    GetTimingCal(barKey);
 	
-	if((*itEndA).second.dataValid
-	   && (*itEndB).second.dataValid) 
-	    barMap.insert(
-		make_pair(barKey, BarData((*itEndB).second, 
-					  (*itEndA).second, calibrations, type)));
-        else {
-	    itEndA = itEndB;
+	const TimingData &right = table.ends[2*loc+RIGHT];
+	const TimingData &left  = table.ends[2*loc+LEFT];
+	if(!right.dataValid || !left.dataValid)
 	    continue;
-	}
-	itEndA = itEndB;
-    } // for(itEndA
+
+	BarData &bar = table.bars[loc];
+	bar = BarData(right, left, GetBarCal(type, loc), type);
+	bar.timeOfFlight.assign(starts.size(), 
+				numeric_limits<double>::quiet_NaN());
+	bar.corTimeOfFlight.assign(starts.size(), 
+				   numeric_limits<double>::quiet_NaN());
+	bar.energy.assign(starts.size(), numeric_limits<double>::quiet_NaN());
+	table.built.push_back(loc);
+    } // for(itLoc
+    sort(table.built.begin(), table.built.end());
 } //void VandleProcessor::BuildBars
 
 
 //********** ClearMaps *********
 void VandleProcessor::ClearMaps(void)
 {
-    barMap.clear();
-    bigMap.clear();
-    smallMap.clear();
-    startMap.clear();
-    tvandleMap.clear();
+    barTables[SMALL_BAR].Clear();
+    barTables[BIG_BAR].Clear();
+    tvandleTable.Clear();
+
+    for(vector<unsigned int>::const_iterator it = startSlots.begin();
+	it != startSlots.end(); it++)
+	hasStart[*it] = false;
+    startSlots.clear();
 }
 
 
 //********** CrossTalk **********
 void VandleProcessor::CrossTalk(void)
 {
-    //This whole routine is stupidly written, it needs cleaned up something fierce.
-    if(barMap.size() < 2)
+    //Information for the bars of interest.
+    const unsigned int locA = 0;
+    const unsigned int locB = 1;
+    const BarTable &table = barTables[SMALL_BAR];
+
+    //built is sorted, so the two bars are present only as its first entries
+    if(table.built.size() < 2 || 
+       table.built[0] != locA || table.built[1] != locB)
 	return;
 
-    for(BarMap::iterator itBarA = barMap.begin(); 
-	itBarA != barMap.end(); itBarA++) {
-	BarMap::iterator itTemp = itBarA;
-	itTemp++;
-	
-	const double &timeAveA = (*itBarA).second.timeAve;
-	const unsigned int &locA = (*itBarA).first.first;
-	
-	for(BarMap::iterator itBarB = itTemp; itBarB != barMap.end(); 
-	    itBarB++) {
-	    if((*itBarA).first.second != (*itBarB).first.second)
-		continue;
-	    if((*itBarA).first == (*itBarB).first)
-		continue;
-	    
-	    const double &timeAveB = (*itBarB).second.timeAve;
-	    const unsigned int &locB = (*itBarB).first.first;
-	    
-	    CrossTalkKey bars(locA, locB);
-	    crossTalk.insert(make_pair(bars, timeAveB - timeAveA));
-	}
-    }
-
-    //Information for the bar of interest.
-    string barType = "small";
-    IdentKey barA(0, barType);
-    IdentKey barB(1, barType);
-
-    CrossTalkKey barsOfInterest(barA.first, barB.first);
-    
-    CrossTalkMap::iterator itBars = 
-	crossTalk.find(barsOfInterest);
+    const BarData &barA = table.bars[locA];
+    const BarData &barB = table.bars[locB];
     
     const int resMult = 2; //set resolution of histograms
     const int resOffset = 200; // set offset of histograms
     
-    if(itBars != crossTalk.end())
-	plot(D_CROSSTALK, (*itBars).second * resMult + resOffset);
+    plot(D_CROSSTALK, (barB.timeAve - barA.timeAve) * resMult + resOffset);
     
     //Carbon Recoil Stuff
-    BarMap::iterator itBarA = barMap.find(barA);
-    BarMap::iterator itBarB = barMap.find(barB);
-    
-    if(itBarA == barMap.end() || itBarB == barMap.end())
-	return;
-    
-//    TimeOfFlightMap::iterator itTofA = 
-// 	(*itBarA).second.timeOfFlight.find(startLoc);
-//     TimeOfFlightMap::iterator itTofB = 
-// 	(*itBarB).second.timeOfFlight.find(startLoc);
-    
-//     if(itTofA == (*itBarA).second.timeOfFlight.end() ||
-//        itTofB == (*itBarB).second.timeOfFlight.end())
-// 	return;
-    
-//     double tofA = (*itTofA).second;
-//     double tofB = (*itTofB).second;
-    double tdiffA = (*itBarA).second.walkCorTimeDiff;
-    double tdiffB = (*itBarB).second.walkCorTimeDiff;
-    double qdcA = (*itBarA).second.qdc;
-    double qdcB = (*itBarB).second.qdc;
+//     double tofA = barA.timeOfFlight[startSlot];
+//     double tofB = barB.timeOfFlight[startSlot];
+    double tdiffA = barA.walkCorTimeDiff;
+    double tdiffB = barB.walkCorTimeDiff;
+    double qdcA = barA.qdc;
+    double qdcB = barB.qdc;
 
     //bool onBar = (tdiffA + tdiffB <= 0.75 && tdiffA + tdiffB >= 0.25);
     bool muon = (qdcA > 7500 && qdcB > 7500);
     
-    double muonTOF = 
-	(*itBarA).second.timeAve - (*itBarB).second.timeAve;
+    double muonTOF = barA.timeAve - barB.timeAve;
 
     plot(3950, tdiffA*resMult+100, tdiffB*resMult+100);
     
@@ -585,42 +590,70 @@ void VandleProcessor::CrossTalk(void)
     
 //     if((tofB > tofA) && (tofB < (tofA+150))) {
 //  	plot(DD_GATEDTQDCAVEVSTOF, tofA*resMult+resOffset, 
-//  	     (*itBarA).second.qdc);
+//  	     barA.qdc);
 //     }
 } //void VandleProcessor::CrossTalk
 
 
-//********** FillMap **********
-void VandleProcessor::FillMap(const vector<ChanEvent*> &eventList, 
-			      const string type, TimingDataMap &eventMap) 
+//********** FillEnds **********
+void VandleProcessor::FillEnds(const vector<ChanEvent*> &eventList, 
+			       unsigned int offset, BarTable &table) 
 {
-    unsigned int OFFSET = 0;
-    if(type == "big")
-	OFFSET = dammIds::BIG_OFFSET;
-    else if(type == "tvandle")
-	OFFSET = dammIds::TVANDLE_OFFSET;
-
     for(vector<ChanEvent*>::const_iterator it = eventList.begin();
 	it != eventList.end(); it++) {
 	unsigned int location = (*it)->GetChanID().GetLocation();
-	string subType = (*it)->GetChanID().GetSubtype();
+	const string &subType = (*it)->GetChanID().GetSubtype();
 	
-	IdentKey key(location, subType);
+	unsigned int side;
+	if(subType == "right")
+	    side = RIGHT;
+	else if(subType == "left")
+	    side = LEFT;
+	else
+	    continue;
+
+	if(location >= table.bars.size())
+	    table.Resize(location + 1);
 	
-	TimingDataMap::iterator itTemp = 
-	    eventMap.insert(make_pair(key, TimingData(*it))).first;
+	//the first hit of an end is kept
+	unsigned int index = 2*location + side;
+	if(!table.hasEnd[index]) {
+	    if(!table.hasEnd[2*location + (1 - side)])
+		table.touched.push_back(location);
+	    table.ends[index] = TimingData(*it);
+	    table.hasEnd[index] = true;
+	}
+
+	const TimingData &end = table.ends[index];
+	if(end.dataValid) {
+	    plot(DD_TQDCBARS + offset, end.tqdc, index);
+	    plot(DD_MAXIMUMBARS + offset, end.maxval, index);
+	}
+    }
+}
+
+
+//********** FillStarts **********
+void VandleProcessor::FillStarts(const vector<ChanEvent*> &eventList) 
+{
+    for(vector<ChanEvent*>::const_iterator it = eventList.begin();
+	it != eventList.end(); it++) {
+	unsigned int location = (*it)->GetChanID().GetLocation();
+	unsigned int slot = 2*location;
+	if((*it)->GetChanID().GetSubtype() == "liquid")
+	    slot++;
+
+	if(slot >= starts.size()) {
+	    starts.resize(2*location + 2);
+	    hasStart.resize(2*location + 2, false);
+	}
 	
-	if(type == "start")
+	//the first hit of a start is kept
+	if(hasStart[slot])
 	    continue;
-    	
-	if((*itTemp).second.dataValid && (*itTemp).first.second == "right") {
-	    plot(DD_TQDCBARS + OFFSET, (*itTemp).second.tqdc, location*2);
-	    plot(DD_MAXIMUMBARS + OFFSET, (*itTemp).second.maxval, location*2);
-	} 
-	else if((*itTemp).second.dataValid && (*itTemp).first.second == "left") {
-	    plot(DD_TQDCBARS + OFFSET, (*itTemp).second.tqdc, location*2+1);
-	    plot(DD_MAXIMUMBARS + OFFSET, (*itTemp).second.maxval, location*2+1);
-	}
+	starts[slot] = TimingData(*it);
+	hasStart[slot] = true;
+	startSlots.push_back(slot);
     }
 }
 
@@ -630,26 +663,30 @@ void VandleProcessor::Tvandle(void)
 {
     //Needs cleaned heavily!!
     using namespace dammIds::tvandle;
-    IdentKey rightKey(0,"right");
-    IdentKey leftKey (1,"left");
+    //The right end is at location 0, the left one at location 1
+    const unsigned int rightIndex = 2*0 + RIGHT;
+    const unsigned int leftIndex  = 2*1 + LEFT;
+    if(tvandleTable.hasEnd.size() <= leftIndex ||
+       !tvandleTable.hasEnd[rightIndex] || !tvandleTable.hasEnd[leftIndex])
+	return;
     
-    TimingDataMap::iterator itRight = tvandleMap.find(rightKey);
-    TimingDataMap::iterator itLeft  = tvandleMap.find(leftKey);
+    const TimingData &right = tvandleTable.ends[rightIndex];
+    const TimingData &left  = tvandleTable.ends[leftIndex];
     
-    // unsigned int maxPosRight = (unsigned int)(*itRight).second.maxpos;
-    // unsigned int maxPosLeft  = (unsigned int)(*itLeft).second.maxpos;
-    unsigned int maxValRight = (unsigned int)(*itRight).second.maxval;
-    unsigned int maxValLeft  = (unsigned int)(*itLeft).second.maxval;
+    // unsigned int maxPosRight = (unsigned int)right.maxpos;
+    // unsigned int maxPosLeft  = (unsigned int)left.maxpos;
+    unsigned int maxValRight = (unsigned int)right.maxval;
+    unsigned int maxValLeft  = (unsigned int)left.maxval;
     double timeDiff = 
-	(*itLeft).second.highResTime - (*itRight).second.highResTime;
+	left.highResTime - right.highResTime;
     double walkCorTimeDiff = 
-	(*itLeft).second.walkCorTime - (*itRight).second.walkCorTime;
+	left.walkCorTime - right.walkCorTime;
 
-    double snrRight = pow((*itRight).second.maxval/(*itRight).second.stdDevBaseline, 2.);
-    double snrLeft = pow((*itLeft).second.maxval/(*itLeft).second.stdDevBaseline, 2.);
+    double snrRight = pow(right.maxval/right.stdDevBaseline, 2.);
+    double snrLeft = pow(left.maxval/left.stdDevBaseline, 2.);
 
-    vector<int> trc = (*itRight).second.trace;
-    vector<int> trc1 = (*itLeft).second.trace;
+    vector<int> trc = *right.trace;
+    vector<int> trc1 = *left.trace;
     if(timeDiff < (1600.-2000.)/50.) {
 	for(vector<int>::iterator it = trc.begin(); it != trc.end(); it++)
 	    plot(DD_PROBLEMS, it-trc.begin(), counter, *it);
@@ -659,24 +696,24 @@ void VandleProcessor::Tvandle(void)
     }
     
     //Fill histograms
-    plot(DD_QDCVSMAX, (*itRight).second.maxval, 
-	 (*itRight).second.tqdc);
+    plot(DD_QDCVSMAX, right.maxval, 
+	 right.tqdc);
    
-    if((*itRight).second.dataValid && 
-       (*itLeft).second.dataValid){
+    if(right.dataValid && 
+       left.dataValid){
 	double timeRes = 50; //100 ps/bin
 	double timeOff = 200; 
 
 	plot(D_TIMEDIFF, timeDiff*timeRes + timeOff);
-	plot(DD_PVSP, (*itRight).second.phase*timeRes-12000, 
-	     (*itLeft).second.phase*timeRes-12000);
+	plot(DD_PVSP, right.phase*timeRes-12000, 
+	     left.phase*timeRes-12000);
 	//plot(DD_MAXVSTDIFF, timeDiff*timeRes+timeOff, maxValRight);
 	
 	//Plot information Pertaining to the SNR
 	plot(D_SNRSTART, snrRight*0.25);
 	plot(D_SNRSTOP, snrLeft*0.25);
-	plot(D_SDEVBASESTART, (*itRight).second.stdDevBaseline*timeRes+timeOff);
-	plot(D_SDEVBASESTOP, (*itLeft).second.stdDevBaseline*timeRes+timeOff);
+	plot(D_SDEVBASESTART, right.stdDevBaseline*timeRes+timeOff);
+	plot(D_SDEVBASESTOP, left.stdDevBaseline*timeRes+timeOff);
 
 	//Plot information used to determine the impact of walk.
 	double tempVal = fabs(maxValRight-maxValLeft);
@@ -690,5 +727,5 @@ void VandleProcessor::Tvandle(void)
 	    plot(DD_MAXSVSTDIFF, 
 		 walkCorTimeDiff*timeRes+timeOff, maxValLeft);
 
-    }// if((*itRight).second.dataValid
+    }// if(right.dataValid
 }
@@ -7,12 +7,34 @@ Written: S. V. Paulauskas 09 May 2011
 **************************************/
 #include <string>
 
-#include "VandleRoot.hpp"
+#include "ColumnFile.hpp"
+#include "VandleROOT.hpp"
 
+#ifdef useroot
 #include <TTree.h>
+#endif
 
 using std::string;
 
+//********** AddColumns **********
+bool VandleROOT::AddColumns(ColumnWriter *writer)
+{
+    smallRight.AddColumns(writer, "VandleSmallRight");
+    smallLeft.AddColumns(writer, "VandleSmallLeft");
+    bigRight.AddColumns(writer, "VandleBigRight");
+    bigLeft.AddColumns(writer, "VandleBigLeft");
+    return true;
+}
+
+
+//********** FillColumns **********
+void VandleROOT::FillColumns(void)
+{
+    FillData();
+}
+
+
+#ifdef useroot
 //********** AddBranch **********
 bool VandleROOT::AddBranch(TTree *tree)
 {
@@ -33,48 +55,53 @@ bool VandleROOT::AddBranch(TTree *tree)
 //********** FillBranch **********
 void VandleROOT::FillBranch(void)
 {
-    FillRoot(smallMap, "small");
-    FillRoot(bigMap, "big");
-    
+    FillData();
+}
+#endif // useroot
+
+
+//********** FillData **********
+void VandleROOT::FillData(void)
+{
+    smallRight = smallLeft = bigRight = bigLeft = DataRoot();
     if (!HasEvent())
-	smallRight = smallLeft = bigRight = bigLeft = DataRoot();
+	return;
+
+    FillRoot(barTables[SMALL_BAR], SMALL_BAR);
+    FillRoot(barTables[BIG_BAR], BIG_BAR);
 }
 
 
 //********** FillRoot **********
-void VandleROOT::FillRoot(const TimingDataMap &endMap, const string &barType)
+void VandleROOT::FillRoot(const BarTable &table, BarType barType)
 {
-    smallRight = smallLeft = bigRight = bigLeft = DataRoot();
     DataRoot *data;
     
-    for(TimingDataMap::const_iterator itTemp = endMap.begin(); 
-	itTemp != endMap.end(); itTemp++) {
-	
-	if(barType == "big") {
-	    if( (*itTemp).first.second == "right") {
-		data = &bigRight;
-	    } else if ((*itTemp).first.second == "left") {
-		data = &bigLeft;
-	    } else continue;
-	} else { 
-	    if( (*itTemp).first.second == "right") {
-		data = &smallRight;
-	    } else if ( (*itTemp).first.second == "left") {
-		data = &smallLeft;
-	    } else continue;
-	}
+    for(std::vector<unsigned int>::const_iterator itLoc = 
+	    table.touched.begin(); itLoc != table.touched.end(); itLoc++) {
+	for(unsigned int side = RIGHT; side <= LEFT; side++) {
+	    if(!table.hasEnd[2*(*itLoc) + side])
+		continue;
 	
-	const TimingData &tempData = (*itTemp).second;
+	    if(barType == BIG_BAR)
+		data = (side == RIGHT) ? &bigRight : &bigLeft;
+	    else
+		data = (side == RIGHT) ? &smallRight : &smallLeft;
 	
-	data->location[data->multiplicity] = (*itTemp).first.first;
-	data->maxval[data->multiplicity] = tempData.maxval;
-	data->tqdc[data->multiplicity] = tempData.tqdc;
-	data->aveBaseline[data->multiplicity] = tempData.aveBaseline;
-	data->highResTime[data->multiplicity] = tempData.highResTime;
-	data->maxpos[data->multiplicity] = tempData.maxpos;
-	data->phase[data->multiplicity] = tempData.phase;
-	data->stdDevBaseline[data->multiplicity] = tempData.stdDevBaseline;
-	data->multiplicity++;
+	    if(data->multiplicity >= DataRoot::maxMultiplicity)
+		continue;
+
+	    const TimingData &tempData = table.ends[2*(*itLoc) + side];
 	
-    } // end for(DataMap::
+	    data->location[data->multiplicity] = *itLoc;
+	    data->maxval[data->multiplicity] = tempData.maxval;
+	    data->tqdc[data->multiplicity] = tempData.tqdc;
+	    data->aveBaseline[data->multiplicity] = tempData.aveBaseline;
+	    data->highResTime[data->multiplicity] = tempData.highResTime;
+	    data->maxpos[data->multiplicity] = tempData.maxpos;
+	    data->phase[data->multiplicity] = tempData.phase;
+	    data->stdDevBaseline[data->multiplicity] = tempData.stdDevBaseline;
+	    data->multiplicity++;
+	}
+    } // end for(itLoc
 } 
@@ -39,26 +39,21 @@ void WaveformAnalyzer::Analyze(Trace &trace,
 {
     TraceAnalyzer::Analyze(trace, detType, detSubtype);
     
-    if(detType == "vandleSmall" || detType == "vandleBig" 
-       || detType == "liquid_scint" || detType == "pulser" 
-       || detType == "tvandle") {
+    if(trace.HasValue("saturation")) {
+	EndAnalyze();
+	return;
+    }
 	
-        if(trace.HasValue("saturation")) {
-	    EndAnalyze();
-	    return;
-	}
-	
-	unsigned int waveformLow = timing_.GetConstant("waveformLow");
-	unsigned int waveformHigh = timing_.GetConstant("waveformHigh");
-	//unsigned int startDiscrimination = GetConstant("startDiscrimination");
-	unsigned int maxPos = trace.FindMaxInfo();
-
-	trace.DoQDC(maxPos-waveformLow, 
-		    waveformHigh+waveformLow);
-	//Temporarly removed due to SegFault Issues
-	// if(detSubtype == "liquid")
-	//     trace.DoDiscrimination(startDiscrimination, 
-	// 			   waveformHigh - startDiscrimination);
-    } //if(detType
+    unsigned int waveformLow = timing_.GetConstant("waveformLow");
+    unsigned int waveformHigh = timing_.GetConstant("waveformHigh");
+    //unsigned int startDiscrimination = GetConstant("startDiscrimination");
+    unsigned int maxPos = trace.FindMaxInfo();
+
+    trace.DoQDC(maxPos-waveformLow, 
+		waveformHigh+waveformLow);
+    //Temporarly removed due to SegFault Issues
+    // if(detSubtype == "liquid")
+    //     trace.DoDiscrimination(startDiscrimination, 
+    // 			   waveformHigh - startDiscrimination);
     EndAnalyze();
 }
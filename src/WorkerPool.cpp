@@ -0,0 +1,134 @@
+/** \file WorkerPool.cpp
+ *
+ * Pool of threads running data parallel stages of the spill analysis
+ */
+#include <cstdlib>
+#include <sstream>
+
+#include "Globals.hpp"
+#include "Messenger.hpp"
+#include "WorkerPool.hpp"
+
+using namespace std;
+
+WorkerPool* WorkerPool::instance = NULL;
+
+/** Instance is created upon first call */
+WorkerPool* WorkerPool::get() {
+    if (!instance) {
+        instance = new WorkerPool();
+    }
+    return instance;
+}
+
+WorkerPool::WorkerPool() {
+    task_ = NULL;
+    context_ = NULL;
+    items_ = 0;
+    generation_ = 0;
+    pending_ = 0;
+    stop_ = false;
+
+    pthread_mutex_init(&mutex_, NULL);
+    pthread_cond_init(&started_, NULL);
+    pthread_cond_init(&finished_, NULL);
+
+    unsigned threads = Globals::get()->traceThreads();
+    if (threads < 2)
+        return;
+
+    /** Workers keep their addresses, the vector is not resized later */
+    workers_.resize(threads - 1);
+    unsigned created = 0;
+    for (; created < workers_.size(); ++created) {
+        workers_[created].pool = this;
+        workers_[created].part = created + 1;
+        if (pthread_create(&workers_[created].thread, NULL,
+                           &WorkerPool::Work, &workers_[created]) != 0)
+            break;
+    }
+    workers_.resize(created);
+    if (created > 0)
+        atexit(&WorkerPool::StopAtExit);
+
+    Messenger m;
+    stringstream ss;
+    ss << "Worker pool: " << Size() << " thread(s)";
+    m.detail(ss.str());
+}
+
+void WorkerPool::StopAtExit() {
+    if (instance)
+        instance->Stop();
+}
+
+void* WorkerPool::Work(void* worker) {
+    Worker* w = static_cast<Worker*>(worker);
+    w->pool->Loop(w->part);
+    return NULL;
+}
+
+void WorkerPool::Run(Task task, void* context, size_t n) {
+    if (n == 0)
+        return;
+    if (workers_.empty()) {
+        task(context, 0, n);
+        return;
+    }
+
+    pthread_mutex_lock(&mutex_);
+    task_ = task;
+    context_ = context;
+    items_ = n;
+    pending_ = workers_.size();
+    ++generation_;
+    pthread_cond_broadcast(&started_);
+    pthread_mutex_unlock(&mutex_);
+
+    RunPart(0);
+
+    pthread_mutex_lock(&mutex_);
+    while (pending_ > 0)
+        pthread_cond_wait(&finished_, &mutex_);
+    pthread_mutex_unlock(&mutex_);
+}
+
+void WorkerPool::RunPart(unsigned part) {
+    size_t begin = items_ * part / Size();
+    size_t end = items_ * (part + 1) / Size();
+    if (begin < end)
+        task_(context_, begin, end);
+}
+
+void WorkerPool::Loop(unsigned part) {
+    unsigned long seen = 0;
+    while (true) {
+        pthread_mutex_lock(&mutex_);
+        while (!stop_ && generation_ == seen)
+            pthread_cond_wait(&started_, &mutex_);
+        if (stop_) {
+            pthread_mutex_unlock(&mutex_);
+            return;
+        }
+        seen = generation_;
+        pthread_mutex_unlock(&mutex_);
+
+        RunPart(part);
+
+        pthread_mutex_lock(&mutex_);
+        if (--pending_ == 0)
+            pthread_cond_signal(&finished_);
+        pthread_mutex_unlock(&mutex_);
+    }
+}
+
+void WorkerPool::Stop() {
+    pthread_mutex_lock(&mutex_);
+    stop_ = true;
+    pthread_cond_broadcast(&started_);
+    pthread_mutex_unlock(&mutex_);
+    for (vector<Worker>::iterator it = workers_.begin();
+         it != workers_.end(); ++it)
+        pthread_join(it->thread, NULL);
+    workers_.clear();
+}
@@ -0,0 +1,103 @@
+/** \file ColumnFileTest.cpp
+ *
+ * Round trip test of the column files: writes a file in several chunks
+ * with the ColumnWriter and checks the header and the values read back
+ * with the ColumnReader. Run with "make test".
+ */
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "ColumnFile.hpp"
+#include "Exceptions.hpp"
+
+using namespace std;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const string& what) {
+        if (!condition) {
+            cout << "FAILED: " << what << endl;
+            ++failures;
+        }
+    }
+
+    const char* fileName = "columnfile_test.col";
+    /** Not a multiple of the chunk size, the last chunk is partial */
+    const unsigned chunkSize = 7;
+    const unsigned numRows = 24;
+}
+
+int main() {
+    double x = 0;
+    int i = 0;
+    unsigned u = 0;
+
+    ColumnWriter* writer = new ColumnWriter(fileName, chunkSize);
+    writer->AddColumn("x", &x);
+    writer->AddColumn("i", &i);
+    writer->AddColumn("u", &u);
+    for (unsigned row = 0; row < numRows; ++row) {
+        x = row * 0.25;
+        i = -(int)row;
+        u = row * 3;
+        writer->Fill();
+        /** An end of spill in the middle of a chunk */
+        if (row == 10)
+            ColumnWriter::FlushAll();
+    }
+    check(writer->GetEntries() == numRows, "writer entries");
+    delete writer;
+
+    try {
+        ColumnReader reader(fileName);
+        check(reader.GetNumColumns() == 3, "number of columns");
+        check(reader.GetName(0) == "x" && reader.GetType(0) == column_double,
+              "header of column x");
+        check(reader.GetName(1) == "i" && reader.GetType(1) == column_int,
+              "header of column i");
+        check(reader.GetName(2) == "u" && reader.GetType(2) == column_int,
+              "header of column u");
+        check(reader.Find("u") == 2 && reader.Find("none") == -1, "Find");
+
+        /** Chunks of 7 rows, the flush after row 10 cuts the second one
+         * to 4 rows: 7, 4, 7, 6 */
+        const unsigned expected[] = {7, 4, 7, 6};
+        unsigned chunks = 0;
+        unsigned row = 0;
+        while (reader.NextChunk()) {
+            if (chunks < sizeof(expected) / sizeof(expected[0])) {
+                stringstream ss;
+                ss << "rows of chunk " << chunks;
+                check(reader.GetRows() == expected[chunks], ss.str());
+            }
+            for (unsigned r = 0; r < reader.GetRows(); ++r, ++row) {
+                stringstream ss;
+                ss << "values of row " << row;
+                check(reader.Get(0, r) == row * 0.25 &&
+                      reader.Get(1, r) == -(double)row &&
+                      reader.Get(2, r) == row * 3.0, ss.str());
+            }
+            ++chunks;
+        }
+        check(chunks == 4, "number of chunks");
+        check(row == numRows, "number of rows read");
+    } catch (GeneralException &e) {
+        cout << "FAILED: " << e.what() << endl;
+        ++failures;
+    }
+
+    try {
+        ColumnReader reader("ColumnFileTest.cpp.missing");
+        check(false, "missing file is reported");
+    } catch (IOException &) {
+        // expected
+    }
+
+    remove(fileName);
+    if (failures == 0)
+        cout << "ColumnFileTest: all checks passed" << endl;
+    return failures == 0 ? 0 : 1;
+}